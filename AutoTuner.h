@@ -0,0 +1,133 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <type_traits>
+#include <algorithm>
+#include "ContainerRegistry.h"
+#include "ConcurrentBenchmark.h"
+using namespace std;
+
+// An auto-tuner for the recommended container. Recommending a hash table is only half the answer without its bucket
+// count and load factor, so once a container is chosen, the tuner searches the knobs its traits expose (tuningSpace)
+// against the workload by coordinate descent: starting from the defaults, it tries every value of one knob with the
+// others held, keeps the best, and moves to the next knob, for a couple of passes. The final gain is measured again
+// with fresh trials, so the tuned setting is not credited with the noise that made it win the search.
+
+// A type trait that checks if a container's traits expose tuning knobs
+template <class Traits, class = void>
+struct is_tunable : false_type {};
+
+template <class Traits>
+struct is_tunable<Traits, void_t<decltype(Traits::tuningSpace(0))>> : true_type {};
+
+// The outcome of tuning one container
+struct TunedConfiguration {
+    string data_structure; // The name of the container that was tuned
+    vector<TuningParameter> parameters; // The knobs that were searched, empty if the container has none
+    vector<double> tuned; // The best value found for each knob
+    double baseline_latency = 0; // The median weighted latency with the default knobs, in microseconds
+    double tuned_latency = 0; // The median weighted latency with the tuned knobs, in microseconds
+    int settings_tried = 0; // The number of distinct settings measured during the search
+
+    // A method that returns how many times faster the tuned setting is than the defaults
+    double gain() const {
+        return tuned_latency > 0 ? baseline_latency / tuned_latency : 1;
+    }
+};
+
+// A function template that tunes one container class for a workload with a given number of trials per setting
+template <class Container>
+TunedConfiguration tune_container(const vector<string>& api, const vector<string>& data, const vector<double>& frequencies,
+                                  int trials = 3, int passes = 2) {
+    using Traits = container_traits<Container>;
+    TunedConfiguration result;
+    result.data_structure = Traits::name;
+    if constexpr (is_tunable<Traits>::value) {
+        result.parameters = Traits::tuningSpace(data.size());
+        // Returns the median weighted latency of a setting over a number of trials, in microseconds
+        auto measure = [&](const vector<double>& setting, int count) {
+            vector<double> latencies;
+            for (int t = 0; t < max(1, count); t++) {
+                Container container = Traits::make(data.size(), setting);
+                vector<int> times = time_workload(container, api, data);
+                double weighted = 0;
+                for (size_t j = 0; j < times.size() && j < frequencies.size(); j++) {
+                    weighted += frequencies[j] * times[j];
+                }
+                latencies.push_back(weighted);
+            }
+            nth_element(latencies.begin(), latencies.begin() + (latencies.size() - 1) / 2, latencies.end());
+            return latencies[(latencies.size() - 1) / 2];
+        };
+
+        vector<double> baseline;
+        for (const TuningParameter& p : result.parameters) {
+            baseline.push_back(p.baseline);
+        }
+        map<vector<double>, double> seen; // Each setting is measured once per search
+        auto cost = [&](const vector<double>& setting) {
+            auto it = seen.find(setting);
+            if (it == seen.end()) {
+                it = seen.insert(make_pair(setting, measure(setting, trials))).first;
+            }
+            return it->second;
+        };
+
+        vector<double> current = baseline;
+        double currentCost = cost(current);
+        for (int pass = 0; pass < passes; pass++) {
+            bool improved = false;
+            for (size_t k = 0; k < result.parameters.size(); k++) {
+                for (double value : result.parameters[k].values) {
+                    vector<double> candidate = current;
+                    candidate[k] = value;
+                    double candidateCost = cost(candidate);
+                    if (candidateCost < currentCost) {
+                        current = candidate;
+                        currentCost = candidateCost;
+                        improved = true;
+                    }
+                }
+            }
+            if (!improved) {
+                break;
+            }
+        }
+        result.tuned = current;
+        result.settings_tried = (int)seen.size();
+        result.baseline_latency = measure(baseline, 2 * trials);
+        result.tuned_latency = current == baseline ? result.baseline_latency : measure(current, 2 * trials);
+    }
+    return result;
+}
+
+// A function that tunes the registered container with a given name, returning a configuration with no parameters if
+// the container has no knobs or is not registered
+inline TunedConfiguration tune_data_structure(const string& ds, const vector<string>& api, const vector<string>& data,
+                                              const vector<double>& frequencies, int trials = 3) {
+    TunedConfiguration result;
+    result.data_structure = ds;
+    RegisteredContainers::forEach([&](auto tag) {
+        using Container = typename decltype(tag)::type;
+        if (ds == container_traits<Container>::name) {
+            result = tune_container<Container>(api, data, frequencies, trials);
+        }
+    });
+    return result;
+}
+
+// A function that prints a tuned configuration next to the defaults, with the measured gain
+inline void print_tuning(const TunedConfiguration& tuning) {
+    if (tuning.parameters.empty()) {
+        cout << "The " << tuning.data_structure << " has no parameters to tune" << endl;
+        return;
+    }
+    cout << "Tuned " << tuning.data_structure << " (" << tuning.settings_tried << " settings tried):";
+    for (size_t k = 0; k < tuning.parameters.size(); k++) {
+        cout << (k == 0 ? " " : ", ") << tuning.parameters[k].name << " " << tuning.tuned[k] << " (default " << tuning.parameters[k].baseline << ")";
+    }
+    cout << endl;
+    cout << "  " << tuning.baseline_latency << " us -> " << tuning.tuned_latency << " us, " << tuning.gain() << "x" << endl;
+}
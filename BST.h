@@ -1,7 +1,9 @@
+#pragma once
 #include <iostream>
 #include <vector>
 #include <string>
 #include <chrono>
+#include "ContainerTraits.h"
 
 using namespace std;
 
@@ -277,7 +279,7 @@ class BST {
                     
                 }
                 else if(method == "search()") {
-                    search(data.back());
+                    benchmark_sink = search(data.back()); // Keep the result so the search is not optimized away
                 }
                 else if(method == "size()") {
                     T x = findMax();
@@ -295,3 +297,22 @@ class BST {
             return time_for_ds;
         }
 };
+
+// The capabilities and costs the search engine matches workloads against
+template <class T>
+struct container_traits<BST<T>> {
+    static constexpr const char* name = "BST";
+    static constexpr unsigned capabilities = Elements | SortedOrder | Iteration;
+    // The tree is not rebalanced, so the costs are for random keys; sorted input makes them linear
+    static constexpr Complexity insertCost = Complexity::Logarithmic;
+    static constexpr Complexity deleteCost = Complexity::Logarithmic;
+    static constexpr Complexity searchCost = Complexity::Logarithmic;
+
+    static constexpr double bytesPerElement(double elementBytes) {
+        return elementBytes + 2 * sizeof(void*) + 16;
+    }
+
+    static BST<T> make(size_t) {
+        return BST<T>();
+    }
+};
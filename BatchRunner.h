@@ -0,0 +1,195 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <map>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include "ContainerRegistry.h"
+#include "RequirementParser.h"
+#include "Ranking.h"
+#include "ParallelRun.h"
+using namespace std;
+
+// A non-interactive batch mode over a file of workload specs. The specs are separated by blank lines or "---" lines,
+// and a spec may also be one line with its requirements separated by semicolons. Specs often share work: two services
+// with different operation mixes over the same API, size and key type run exactly the same benchmark, and only weight
+// its method times differently. So the batch first collects the distinct (container, API, size, key type) units, runs
+// each of them once, and then ranks every spec from the shared results. Worker threads only generate the data, one set
+// per distinct size and key type; the units are timed one at a time, since benchmarks running side by side would slow
+// each other down and skew the comparison.
+
+// The result for one spec of a batch
+struct BatchRecord {
+    int index; // The spec's position in the file, from 0
+    string spec; // The spec's text
+    vector<string> candidates; // The containers that meet its requirements
+    vector<CandidateMeasurement> measurements; // The candidates' measurements weighted by its operation mix
+    string best; // The recommended container, or empty if the spec failed
+    string error; // Why the spec failed, or empty
+};
+
+// A function that splits the text of a spec file into specs, dropping empty ones
+inline vector<string> split_spec_file(const string& text) {
+    vector<string> specs;
+    stringstream in(text);
+    string line;
+    string current;
+    while (getline(in, line)) {
+        string trimmed = trim_lower(line);
+        if (trimmed.empty() || trimmed == "---") {
+            if (!trim_lower(current).empty()) {
+                specs.push_back(current);
+            }
+            current.clear();
+        }
+        else {
+            current += line + "\n";
+        }
+    }
+    if (!trim_lower(current).empty()) {
+        specs.push_back(current);
+    }
+    return specs;
+}
+
+// A function that runs every spec of a batch with a number of trials per benchmark, generating the data on a number of
+// threads, and sharing each distinct benchmark among the specs that need it. Reports how many benchmarks ran, against how many the specs asked
+// for, through the two counts. A spec larger than maxWorkloadSize, or whose benchmark of some candidate throws, fails on its own record
+// while the rest of the batch goes on.
+inline vector<BatchRecord> run_batch(const vector<string>& specs, int threads, int trials, int& unitsRun, int& unitsRequested, long long maxWorkloadSize = 1 << 20) {
+    vector<BatchRecord> records(specs.size());
+    vector<WorkloadProfile> profiles(specs.size());
+    map<string, int> unitIndex; // The index of each distinct unit, by its key
+    vector<string> unitContainer; // The container each unit runs
+    vector<int> unitProfile; // The first spec that needs each unit, whose API, size and key type it uses
+    map<string, int> dataIndex; // The index of each distinct data set, by size and key type
+    vector<int> dataProfile; // The first spec that needs each data set
+    vector<int> unitData; // The data set each unit runs on
+    vector<vector<int>> specUnits(specs.size()); // The units each spec needs, one per candidate
+    unitsRequested = 0;
+
+    for (size_t i = 0; i < specs.size(); i++) {
+        records[i].index = (int)i;
+        records[i].spec = specs[i];
+        try {
+            profiles[i] = parse_requirements(specs[i]);
+        }
+        catch (const invalid_argument& e) {
+            records[i].error = e.what();
+            continue;
+        }
+        if (profiles[i].maxSize > maxWorkloadSize) { // Caught before any data is generated for it
+            records[i].error = "The size " + to_string(profiles[i].maxSize) + " is above the batch's limit of " + to_string(maxWorkloadSize);
+            continue;
+        }
+        records[i].candidates = filter_candidates(profiles[i]);
+        if (records[i].candidates.empty()) {
+            records[i].error = "No data structure meets every requirement of the spec";
+            continue;
+        }
+        for (const string& ds : records[i].candidates) {
+            string key = ds + "|" + to_string(profiles[i].maxSize) + "|" + profiles[i].keyType;
+            for (const string& operation : profiles[i].operations) {
+                key += "|" + operation;
+            }
+            auto it = unitIndex.find(key);
+            if (it == unitIndex.end()) {
+                it = unitIndex.insert(make_pair(key, (int)unitContainer.size())).first;
+                unitContainer.push_back(ds);
+                unitProfile.push_back((int)i);
+                string dataKey = to_string(profiles[i].maxSize) + "|" + profiles[i].keyType;
+                auto data = dataIndex.find(dataKey);
+                if (data == dataIndex.end()) {
+                    data = dataIndex.insert(make_pair(dataKey, (int)dataProfile.size())).first;
+                    dataProfile.push_back((int)i);
+                }
+                unitData.push_back(data->second);
+            }
+            specUnits[i].push_back(it->second);
+            unitsRequested++;
+        }
+    }
+    unitsRun = (int)unitContainer.size();
+
+    // Generate the data sets on the workers, each taking the next one not yet taken, then time the units one at a time
+    vector<vector<string>> dataSets(dataProfile.size());
+    atomic<size_t> next(0);
+    run_parallel(max(1, min(threads, (int)dataSets.size())), [&](int) {
+        for (size_t d = next++; d < dataSets.size(); d = next++) {
+            dataSets[d] = generate_workload_data(profiles[dataProfile[d]]);
+        }
+    });
+    vector<TrialResults> results(unitContainer.size());
+    vector<string> unitError(unitContainer.size()); // Why each unit's benchmark failed, or empty
+    for (size_t u = 0; u < unitContainer.size(); u++) {
+        try {
+            results[u] = run_trials(unitContainer[u], profiles[unitProfile[u]].operations, dataSets[unitData[u]], trials);
+        }
+        catch (const exception& e) {
+            unitError[u] = "Benchmark of " + unitContainer[u] + " failed: " + e.what();
+        }
+    }
+
+    RankingWeights weights;
+    for (size_t i = 0; i < specs.size(); i++) {
+        if (!records[i].error.empty()) {
+            continue;
+        }
+        for (int u : specUnits[i]) {
+            if (!unitError[u].empty()) {
+                records[i].error = unitError[u];
+                break;
+            }
+            records[i].measurements.push_back(summarize_trials(results[u], profiles[i].frequencies));
+        }
+        if (!records[i].error.empty()) {
+            records[i].measurements.clear();
+            continue;
+        }
+        records[i].best = get_pareto_best_data_structure(records[i].measurements, weights);
+    }
+    return records;
+}
+
+// A helper function that returns a string as a JSON string literal
+inline string json_string(const string& text) {
+    string result = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        }
+        else if (c == '\n') {
+            result += "\\n";
+        }
+        else if ((unsigned char)c < 0x20) {
+            result += ' ';
+        }
+        else {
+            result += c;
+        }
+    }
+    return result + "\"";
+}
+
+// A function that writes one JSON object per line for each record of a batch
+inline void write_batch_records(ostream& out, const vector<BatchRecord>& records) {
+    for (const BatchRecord& r : records) {
+        out << "{\"index\": " << r.index << ", \"spec\": " << json_string(r.spec);
+        if (!r.error.empty()) {
+            out << ", \"error\": " << json_string(r.error) << "}" << "\n";
+            continue;
+        }
+        out << ", \"best\": " << json_string(r.best) << ", \"candidates\": [";
+        for (size_t k = 0; k < r.measurements.size(); k++) {
+            const CandidateMeasurement& m = r.measurements[k];
+            out << (k == 0 ? "" : ", ") << "{\"data_structure\": " << json_string(m.data_structure) << ", \"p50_us\": " << m.p50_latency
+                << ", \"max_us\": " << m.max_latency << ", \"items_per_second\": " << (long long)m.throughput
+                << ", \"bytes_per_element\": " << m.bytes_per_element << ", \"allocations_per_element\": " << m.allocations_per_element << "}";
+        }
+        out << "]}" << "\n";
+    }
+}
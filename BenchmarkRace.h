@@ -0,0 +1,143 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include "ContainerRegistry.h"
+#include "Ranking.h"
+using namespace std;
+
+// A racing scheduler for the benchmark. Instead of giving every candidate the full budget, it runs the candidates in
+// rounds of successive halving: short trials on a small prefix of the data first, then on prefixes a few times larger,
+// and the full data last. After each round a candidate is dropped once it is clearly beaten, which means another candidate
+// has a 95% confidence interval for latency entirely below its own, holds no more memory and makes no more allocations
+// per element, and has operation costs that grow no slower than its own. The last condition keeps a candidate that is
+// slow on small inputs but will overtake the leader as the input grows, such as a binary search against a linear scan.
+
+// How a race is run
+struct RaceSettings {
+    int rounds = 3; // The number of rounds, the last one on the full data
+    int growth = 4; // How many times larger each round's data is than the one before
+    int trials = 3; // The trials per candidate in each round before the last
+    int finalTrials = 5; // The trials per candidate in the last round, as for an unraced measurement
+    size_t minSize = 64; // The smallest data prefix worth timing
+};
+
+// The outcome of a race
+struct RaceResult {
+    vector<CandidateMeasurement> finalists; // The candidates that reached the last round, measured on the full data
+    vector<string> dropped; // The candidates dropped along the way, in the order they went
+    vector<int> droppedInRound; // The round each dropped candidate went out in
+    long long microseconds = 0; // The time the whole race took
+};
+
+// A helper function that returns the two-sided 95% Student t value for a number of samples
+inline double t_value_95(size_t samples) {
+    static const double table[] = {12.71, 4.30, 3.18, 2.78, 2.57, 2.45, 2.36, 2.31, 2.26};
+    if (samples < 2) {
+        return table[0];
+    }
+    return samples - 2 < sizeof(table) / sizeof(table[0]) ? table[samples - 2] : 1.96;
+}
+
+// A helper function that returns the 95% confidence interval for the mean latency of a measurement, in microseconds. The
+// benchmark times methods in whole microseconds, so the interval is never narrower than that on either side.
+inline pair<double,double> latency_interval(const CandidateMeasurement& m) {
+    double n = max((size_t)1, m.latencies.size());
+    double mean = 0;
+    for (double latency : m.latencies) {
+        mean += latency;
+    }
+    mean /= n;
+    double variance = 0;
+    for (double latency : m.latencies) {
+        variance += (latency - mean) * (latency - mean);
+    }
+    variance = m.latencies.size() > 1 ? variance / (n - 1) : 0;
+    double halfWidth = max(1.0, t_value_95(m.latencies.size()) * sqrt(variance / n));
+    return make_pair(mean - halfWidth, mean + halfWidth);
+}
+
+// A helper function that returns how fast the costliest of the workload's insert(), delete() and search() calls grows
+// for a named container, as a Complexity rank
+inline int workload_growth(const string& ds, const vector<string>& api, const vector<double>& frequencies) {
+    int index = RegisteredContainers::indexOf(ds.c_str());
+    if (index < 0) {
+        return (int)Complexity::Linearithmic;
+    }
+    const ContainerInfo& info = RegisteredContainers::entries[index];
+    int growth = (int)Complexity::Constant;
+    for (size_t j = 0; j < api.size() && j < frequencies.size(); j++) {
+        if (frequencies[j] <= 0) {
+            continue;
+        }
+        if (api[j] == "insert()") growth = max(growth, (int)info.insertCost);
+        else if (api[j] == "delete()") growth = max(growth, (int)info.deleteCost);
+        else if (api[j] == "search()") growth = max(growth, (int)info.searchCost);
+    }
+    return growth;
+}
+
+// A function that races the named candidates and measures the ones left on the full data
+inline RaceResult race_candidates(const vector<string>& data_structures, const vector<string>& api, const vector<string>& data,
+                                  const vector<double>& frequencies, const RaceSettings& settings = RaceSettings()) {
+    auto start = chrono::high_resolution_clock::now();
+    RaceResult result;
+    vector<string> alive = data_structures;
+    int rounds = max(1, settings.rounds);
+
+    for (int round = 0; round < rounds; round++) {
+        bool last = round == rounds - 1;
+        size_t size = data.size();
+        for (int r = round; r < rounds - 1; r++) {
+            size /= max(2, settings.growth);
+        }
+        if (!last && (size < settings.minSize || alive.size() <= 1)) { // Too small to say anything, or nothing left to race
+            continue;
+        }
+        vector<string> prefix(data.begin(), data.begin() + size);
+        vector<CandidateMeasurement> measured = measure_candidates(alive, api, prefix, frequencies, last ? settings.finalTrials : settings.trials);
+        if (last) {
+            result.finalists = measured;
+            break;
+        }
+
+        vector<pair<double,double>> intervals;
+        vector<int> growth;
+        for (const CandidateMeasurement& m : measured) {
+            intervals.push_back(latency_interval(m));
+            growth.push_back(workload_growth(m.data_structure, api, frequencies));
+        }
+        vector<string> survivors;
+        for (size_t i = 0; i < measured.size(); i++) {
+            bool beaten = false;
+            for (size_t j = 0; j < measured.size() && !beaten; j++) {
+                beaten = j != i && intervals[j].second < intervals[i].first && growth[j] <= growth[i]
+                      && measured[j].bytes_per_element <= measured[i].bytes_per_element
+                      && measured[j].allocations_per_element <= measured[i].allocations_per_element;
+            }
+            if (beaten) {
+                result.dropped.push_back(measured[i].data_structure);
+                result.droppedInRound.push_back(round);
+            }
+            else {
+                survivors.push_back(measured[i].data_structure);
+            }
+        }
+        alive = survivors;
+    }
+
+    auto stop = chrono::high_resolution_clock::now();
+    result.microseconds = chrono::duration_cast<chrono::microseconds>(stop - start).count();
+    return result;
+}
+
+// A function that prints which candidates a race dropped and when, and how long it took
+inline void print_race(const RaceResult& race) {
+    for (size_t i = 0; i < race.dropped.size(); i++) {
+        cout << "  dropped " << race.dropped[i] << " after round " << race.droppedInRound[i] + 1 << endl;
+    }
+    cout << "  " << race.finalists.size() << " finalists measured in " << race.microseconds / 1000 << " ms" << endl;
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include "ConcurrentQueue.h"
+#include "ConcurrentStack.h"
+#include "ConcurrentHashTable.h"
+#include "CSRGraph.h"
+#include "Graph.h"
+#include "GraphGenerator.h"
+#include "GraphLoader.h"
+#include "DynamicGraph.h"
+using namespace std;
+
+// The dedicated benchmarks of the concurrent containers and the graph engines, which the recommendation benchmarks do not
+// reach. Main runs one of them by name with --bench NAME (or every one with --bench all), on --size N items per thread or
+// vertices, with up to --threads N threads (one per core by default), and for the graph benchmarks on the generated graph
+// named by --graph MODEL ("erdos-renyi", "rmat" or "grid").
+
+// The settings of a benchmark run
+struct BenchSettings {
+    long long size = 100000; // The items or operations per thread, or the number of vertices of a generated graph
+    int threads = 0; // The most threads to use, or 0 for one per core
+    string model = "rmat"; // The generator of the graph benchmarks
+};
+
+// A helper function that returns the number of threads a setting asks for, where 0 means one per core
+inline int bench_threads(int threads) {
+    return threads > 0 ? threads : max(1, (int)thread::hardware_concurrency());
+}
+
+// A function that benchmarks the SPSC queue and the MPMC queue with half the threads producing and half consuming, moving
+// one element and 32 elements at a time
+inline void bench_queue(const BenchSettings& settings, ostream& out) {
+    int pairs = max(1, bench_threads(settings.threads) / 2);
+    for (size_t batch : {(size_t)1, (size_t)32}) {
+        out << "spsc queue, batch " << batch << ": " << SpscQueue<int>::get_throughput(settings.size, 1024, batch) << " items/s" << endl;
+        out << "mpmc queue, " << pairs << (pairs == 1 ? " producer and " : " producers and ") << pairs
+            << (pairs == 1 ? " consumer" : " consumers") << ", batch " << batch << ": "
+            << MpmcQueue<int>::get_throughput(pairs, pairs, settings.size, 1024, batch) << " items/s" << endl;
+    }
+}
+
+// A function that benchmarks push/pop pairs on the lock-free stack against a mutex-wrapped Stack
+inline void bench_stack(const BenchSettings& settings, ostream& out) {
+    for (const vector<long long>& row : ConcurrentStack<int>::get_contention_benchmark(settings.size, bench_threads(settings.threads))) {
+        out << "stack @ " << row[0] << " threads: lock-free " << row[1] << " ops/s, mutex " << row[2] << " ops/s" << endl;
+    }
+}
+
+// A function that benchmarks the read-heavy and write-heavy mixes on the sharded hash table at every thread count
+inline void bench_hash_table(const BenchSettings& settings, ostream& out) {
+    for (int threads = 1; threads <= bench_threads(settings.threads); threads++) {
+        vector<long long> rates = ConcurrentHashTable<int,int>::get_benchmark(threads, settings.size);
+        out << "hash table @ " << threads << " threads: read-heavy " << rates[0] << " ops/s, write-heavy " << rates[1] << " ops/s" << endl;
+    }
+}
+
+// A function that benchmarks the parallel direction-optimizing search on a frozen generated graph at 1, 2, 4, ... threads
+inline void bench_bfs(const BenchSettings& settings, ostream& out) {
+    int n = (int)settings.size;
+    CSRGraph<int> g = CSRGraph<int>::fromEdgeList(n, generate_edges(settings.model, n));
+    for (const vector<double>& row : g.get_teps(0, bench_threads(settings.threads))) {
+        out << "bfs @ " << (int)row[0] << " threads: " << row[1] * 1e6 << " us, " << (long long)row[2] << " edges/s" << endl;
+    }
+}
+
+// A function that benchmarks the graph workloads on a generated graph
+inline void bench_graph(const BenchSettings& settings, ostream& out) {
+    vector<int> times = Graph<int>::get_graph_time_taken(settings.model, (int)settings.size);
+    out << "graph: insert " << times[0] << " us, bfs " << times[1] << " us, dfs " << times[2] << " us, 100 connectivity queries "
+        << times[3] << " us, neighbor lookups " << times[4] << " us" << endl;
+}
+
+// A function that benchmarks the shortest-path searches on a generated graph with random weights
+inline void bench_shortest_paths(const BenchSettings& settings, ostream& out) {
+    vector<int> times = Graph<int>::get_shortest_path_time_taken(settings.model, (int)settings.size, bench_threads(settings.threads));
+    out << "shortest paths: dijkstra (binary heap) " << times[0] << " us, dijkstra (4-ary heap) " << times[1] << " us, delta-stepping "
+        << times[2] << " us, 100 bidirectional queries " << times[3] << " us" << endl;
+}
+
+// A function that benchmarks loading a generated graph from a text edge list and from a snapshot
+inline void bench_load(const BenchSettings& settings, ostream& out) {
+    vector<int> times = get_load_time_taken(settings.model, (int)settings.size, bench_threads(settings.threads));
+    out << "load: parse " << times[0] << " us, build csr " << times[1] << " us, save snapshot " << times[2] << " us, load snapshot "
+        << times[3] << " us" << endl;
+}
+
+// A function that benchmarks the component, strongly connected component and topological sort passes on a generated graph
+inline void bench_connectivity(const BenchSettings& settings, ostream& out) {
+    vector<int> times = Graph<int>::get_connectivity_time_taken(settings.model, (int)settings.size, bench_threads(settings.threads));
+    out << "connectivity: union-find " << times[0] << " us, label propagation " << times[1] << " us, tarjan " << times[2]
+        << " us, kosaraju " << times[3] << " us, topological sort " << times[4] << " us" << endl;
+}
+
+// A function that benchmarks traversals of a generated graph under each vertex ordering
+inline void bench_reorder(const BenchSettings& settings, ostream& out) {
+    vector<string> orderings = {"as given", "degree", "reverse cuthill-mckee", "breadth-first", "gorder"};
+    vector<vector<int>> rows = Graph<int>::get_reorder_time_taken(settings.model, (int)settings.size);
+    for (size_t i = 0; i < rows.size(); i++) {
+        out << "reorder " << orderings[i] << ": ordering " << rows[i][0] << " us, bfs and dfs " << rows[i][1] << " us" << endl;
+    }
+}
+
+// A function that benchmarks k-hop counting from 512 random sources, one search at a time against multi-source searches
+inline void bench_khop(const BenchSettings& settings, ostream& out) {
+    int n = (int)settings.size;
+    CSRGraph<int> g = CSRGraph<int>::fromEdgeList(n, generate_edges(settings.model, n));
+    for (int k : {2, -1}) {
+        vector<int> times = g.get_khop_time_taken(512, k);
+        out << "khop " << (k < 0 ? string("unbounded") : to_string(k) + " hops") << ": one at a time " << times[0]
+            << " us, multi-source " << times[1] << " us" << endl;
+    }
+}
+
+// A function that benchmarks a churning mix of edge inserts, removals and lookups on Graph and on DynamicGraph
+inline void bench_churn(const BenchSettings& settings, ostream& out) {
+    vector<int> times = DynamicGraph<int>::get_churn_time_taken(settings.model, (int)settings.size, settings.size);
+    out << "churn: graph " << times[0] << " us, dynamic graph " << times[1] << " us" << endl;
+}
+
+// The benchmarks by name, in the order --bench all runs them
+inline const vector<pair<string, void (*)(const BenchSettings&, ostream&)>> bench_suite = {
+    {"queue", bench_queue},
+    {"stack", bench_stack},
+    {"hash-table", bench_hash_table},
+    {"bfs", bench_bfs},
+    {"graph", bench_graph},
+    {"shortest-paths", bench_shortest_paths},
+    {"load", bench_load},
+    {"connectivity", bench_connectivity},
+    {"reorder", bench_reorder},
+    {"khop", bench_khop},
+    {"churn", bench_churn}
+};
+
+// A function that runs the named benchmark, or every one for "all", throwing invalid_argument for an unknown name or a
+// size below one
+inline void run_bench(const string& name, const BenchSettings& settings, ostream& out) {
+    if (settings.size < 1 || settings.size > INT32_MAX) {
+        throw invalid_argument("The benchmark size must be between 1 and " + to_string(INT32_MAX));
+    }
+    bool found = false;
+    for (const auto& bench : bench_suite) {
+        if (name == "all" || name == bench.first) {
+            bench.second(settings, out);
+            found = true;
+        }
+    }
+    if (!found) {
+        string names;
+        for (const auto& bench : bench_suite) {
+            names += " " + bench.first;
+        }
+        throw invalid_argument("Unknown benchmark " + name + "; expected all or one of" + names);
+    }
+}
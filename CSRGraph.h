@@ -0,0 +1,740 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <stdexcept>
+#include <random>
+#include "MappedFile.h"
+#include "ParallelRun.h"
+#include "VisitMarks.h"
+using namespace std;
+
+// The result of a parallel breadth-first search: each vertex's parent in the search tree and its distance from the source
+struct BfsResult {
+    vector<int> parent; // The vertex each vertex was reached from, the source for the source itself, or -1 if unreached
+    vector<int> distance; // The number of edges from the source, or -1 if unreached
+    long long edgesTraversed; // The edges in the reached component, the figure TEPS is measured against
+};
+
+// The scratch arrays of a multi-source breadth-first search, kept between batches so each batch only clears what it touched
+struct MsBfsWorkspace {
+    vector<uint64_t> seen; // Bit i of seen[v] is set once source i of the batch has reached v
+    vector<uint64_t> visit; // The sources whose frontier holds v in the current level
+    vector<uint64_t> visitNext; // The sources whose frontier will hold v in the next level
+    vector<int> frontier; // The vertices with a non-zero visit word
+    vector<int> nextFrontier; // The vertices with a non-zero visitNext word
+    vector<int> touched; // The vertices with a non-zero seen word, cleared at the start of the next batch
+};
+
+// The scratch space of the CSRGraph traversals. It belongs to the calling thread rather than to a graph, so any number of
+// threads can query one frozen graph at once, and each thread reuses its own from one call to the next. A visitor must
+// therefore not start another traversal on the same thread before its own one returns.
+struct CSRTraversalScratch {
+    VisitMarks marks; // The visited flags, reused by every traversal through generation stamps
+    vector<pair<int, long long>> dfsStack; // The explicit depth-first stack of (vertex, next neighbor position)
+    vector<int> bfsQueue; // The breadth-first queue
+    MsBfsWorkspace msBfs; // The workspace of the multi-source searches this thread runs
+};
+
+// A function that returns the calling thread's traversal scratch space
+inline CSRTraversalScratch& csr_traversal_scratch() {
+    static thread_local CSRTraversalScratch scratch;
+    return scratch;
+}
+
+// A function that checks every edge of an edge list joins two of the vertices 0 .. n - 1, throwing out_of_range if not,
+// so the builders can index by vertex without checking each edge again
+template <class T>
+void check_edge_list(int n, const vector<pair<T,T>>& edges) {
+    for (size_t e = 0; e < edges.size(); e++) {
+        if (edges[e].first < 0 || edges[e].first >= n || edges[e].second < 0 || edges[e].second >= n) {
+            throw out_of_range("Edge " + to_string(e) + " names a vertex outside 0 .. " + to_string(n - 1));
+        }
+    }
+}
+
+// The fixed header at the start of a CSR snapshot file, padded to 32 bytes so the offsets that follow stay 8-byte aligned
+struct CSRSnapshotHeader {
+    char magic[4]; // Always "CSRG"
+    uint32_t version; // The layout version, bumped whenever the layout changes
+    uint32_t directed; // 1 if the edges only go one way
+    uint32_t valueSize; // sizeof(T), so a snapshot is never read back as a different vertex type
+    int64_t numVertices; // The number of vertices; numVertices + 1 offsets follow the header
+    int64_t numEntries; // The number of stored edge endpoints; that many neighbors follow the offsets
+};
+
+// A class template for graphs frozen into compressed sparse row form: the neighbors of every vertex
+// are stored back to back in one flat array, and offsets[v] .. offsets[v + 1] marks the slice of vertex v
+template <class T>
+class CSRGraph {
+    private:
+        int numVertices; // The number of vertices in the graph
+        vector<long long> offsets; // The start of each vertex's neighbors in the flat array, plus one end marker
+        vector<T> neighbors; // The neighbors of all vertices, one vertex after another
+        bool directed; // Whether each stored edge only goes one way (bottom-up search needs incoming edges, so it is skipped)
+
+    public:
+        // A default constructor that creates an empty graph
+        CSRGraph() {
+            numVertices = 0;
+            directed = false;
+            offsets.assign(1, 0);
+        }
+
+        // A constructor that freezes existing adjacency lists, keeping every vertex's neighbor order
+        CSRGraph(const vector<vector<T>>& adjList, bool isDirected = false) {
+            numVertices = (int)adjList.size();
+            directed = isDirected;
+            offsets.resize(numVertices + 1);
+            offsets[0] = 0;
+            for (int v = 0; v < numVertices; v++) { // Prefix sum of the degrees gives each vertex's slice
+                offsets[v + 1] = offsets[v] + (long long)adjList[v].size();
+            }
+            neighbors.resize(offsets[numVertices]); // One allocation for every edge endpoint
+            for (int v = 0; v < numVertices; v++) {
+                copy(adjList[v].begin(), adjList[v].end(), neighbors.begin() + offsets[v]);
+            }
+        }
+
+        // A method that builds the graph straight from an edge list on several threads. Neighbors end up in edge-list order,
+        // so the result matches adding the same edges one by one to a Graph and freezing it. Undirected edges are stored both ways.
+        // Throws out_of_range if an edge names a vertex outside 0 .. n - 1.
+        static CSRGraph<T> fromEdgeList(int n, const vector<pair<T,T>>& edges, bool directed = false, int threads = 0) {
+            check_edge_list(n, edges);
+            CSRGraph<T> g;
+            g.numVertices = n;
+            g.directed = directed;
+            long long m = (long long)edges.size();
+            if (threads <= 0) {
+                threads = max(1, (int)thread::hardware_concurrency());
+            }
+            threads = (int)max(1LL, min((long long)threads, m / max(n, 1))); // Each thread keeps n counters, so only use as many threads as the edges can pay for
+            long long chunk = (m + threads - 1) / threads; // The edges each thread handles
+
+            // First pass: every thread counts the endpoints in its own chunk of edges
+            vector<vector<long long>> cursor(threads, vector<long long>(n, 0));
+            run_parallel(threads, [&](int t) {
+                long long first = t * chunk;
+                long long last = min(m, first + chunk);
+                vector<long long>& count = cursor[t];
+                for (long long e = first; e < last; e++) {
+                    count[edges[e].first]++;
+                    if (!directed) {
+                        count[edges[e].second]++;
+                    }
+                }
+            });
+
+            // Prefix sum of the total degrees gives each vertex's slice
+            g.offsets.assign(n + 1, 0);
+            for (int v = 0; v < n; v++) {
+                long long degree = 0;
+                for (int t = 0; t < threads; t++) {
+                    degree += cursor[t][v];
+                }
+                g.offsets[v + 1] = g.offsets[v] + degree;
+            }
+
+            // Turn each thread's counts into its write cursors: chunk t writes after the endpoints of chunks 0 .. t - 1
+            run_parallel(threads, [&](int t) {
+                int first = (int)((long long)n * t / threads);
+                int last = (int)((long long)n * (t + 1) / threads);
+                for (int v = first; v < last; v++) {
+                    long long position = g.offsets[v];
+                    for (int c = 0; c < threads; c++) {
+                        long long count = cursor[c][v];
+                        cursor[c][v] = position;
+                        position += count;
+                    }
+                }
+            });
+
+            // Second pass: every thread scatters its chunk into the slots reserved for it
+            g.neighbors.resize(g.offsets[n]);
+            run_parallel(threads, [&](int t) {
+                long long first = t * chunk;
+                long long last = min(m, first + chunk);
+                vector<long long>& position = cursor[t];
+                for (long long e = first; e < last; e++) {
+                    T u = edges[e].first;
+                    T v = edges[e].second;
+                    g.neighbors[position[u]++] = v;
+                    if (!directed) {
+                        g.neighbors[position[v]++] = u;
+                    }
+                }
+            });
+            return g;
+        }
+
+        // A method that returns the number of vertices in the graph
+        int getNumVertices() const {
+            return numVertices;
+        }
+
+        // A method that returns the number of stored edge endpoints (twice the edge count for an undirected graph)
+        long long getNumEdges() const {
+            return (long long)neighbors.size();
+        }
+
+        // A method that returns the number of neighbors of a given vertex
+        int degree(int v) const {
+            return (int)(offsets[v + 1] - offsets[v]);
+        }
+
+        // A method that returns a pointer to the first neighbor of a given vertex
+        const T* neighborsBegin(int v) const {
+            return neighbors.data() + offsets[v];
+        }
+
+        // A method that returns a pointer past the last neighbor of a given vertex
+        const T* neighborsEnd(int v) const {
+            return neighbors.data() + offsets[v + 1];
+        }
+
+        // A method that checks if each stored edge only goes one way
+        bool isDirected() const {
+            return directed;
+        }
+
+        // A method that writes the graph to a binary snapshot: a header followed by the raw offsets and neighbor arrays,
+        // so loading it back is two bulk copies instead of parsing and rebuilding
+        void saveSnapshot(const string& path) const {
+            ofstream out(path, ios::binary | ios::trunc);
+            if (!out) {
+                throw runtime_error("Cannot write " + path);
+            }
+            CSRSnapshotHeader header = {{'C', 'S', 'R', 'G'}, 1, directed ? 1u : 0u, (uint32_t)sizeof(T), numVertices, (int64_t)neighbors.size()};
+            out.write((const char*)&header, sizeof(header));
+            out.write((const char*)offsets.data(), offsets.size() * sizeof(long long));
+            out.write((const char*)neighbors.data(), neighbors.size() * sizeof(T));
+            if (!out) {
+                throw runtime_error("Cannot write " + path);
+            }
+        }
+
+        // A static method that reads a graph back from a snapshot written by saveSnapshot, throwing runtime_error if the file
+        // is not a snapshot of this vertex type, is cut short, or holds offsets or neighbors that would index outside the graph
+        static CSRGraph<T> loadSnapshot(const string& path) {
+            MappedFile file(path);
+            CSRSnapshotHeader header;
+            if (file.size() < sizeof(header)) {
+                throw runtime_error(path + " is not a graph snapshot");
+            }
+            memcpy(&header, file.data(), sizeof(header));
+            if (memcmp(header.magic, "CSRG", 4) != 0 || header.version != 1 || header.valueSize != sizeof(T)) {
+                throw runtime_error(path + " is not a graph snapshot of this vertex type");
+            }
+            if (header.numVertices < 0 || header.numVertices > INT32_MAX || header.numEntries < 0) {
+                throw runtime_error(path + " is corrupt: bad vertex or edge count");
+            }
+            // The vertex count fits in an int, so the offset bytes cannot overflow; the neighbor bytes are checked by division
+            uint64_t offsetBytes = ((uint64_t)header.numVertices + 1) * sizeof(long long);
+            uint64_t rest = file.size() - sizeof(header);
+            if (offsetBytes > rest || (uint64_t)header.numEntries != (rest - offsetBytes) / sizeof(T)
+                || (rest - offsetBytes) % sizeof(T) != 0) {
+                throw runtime_error(path + " is truncated");
+            }
+            CSRGraph<T> g;
+            g.numVertices = (int)header.numVertices;
+            g.directed = header.directed != 0;
+            const char* cursor = file.data() + sizeof(header);
+            g.offsets.resize(header.numVertices + 1);
+            memcpy(g.offsets.data(), cursor, g.offsets.size() * sizeof(long long));
+            cursor += g.offsets.size() * sizeof(long long);
+            g.neighbors.resize(header.numEntries);
+            if (header.numEntries > 0) { // An empty vector's data() may be null, which memcpy must never see
+                memcpy(g.neighbors.data(), cursor, g.neighbors.size() * sizeof(T));
+            }
+
+            // Every traversal trusts the offsets and neighbor ids, so check them once here
+            if (g.offsets[0] != 0 || g.offsets[g.numVertices] != header.numEntries) {
+                throw runtime_error(path + " is corrupt: the offsets do not span the neighbor array");
+            }
+            for (int v = 0; v < g.numVertices; v++) {
+                if (g.offsets[v] > g.offsets[v + 1]) {
+                    throw runtime_error(path + " is corrupt: the offsets of vertex " + to_string(v) + " go backwards");
+                }
+            }
+            for (const T& w : g.neighbors) {
+                if ((long long)w < 0 || (long long)w >= g.numVertices) {
+                    throw runtime_error(path + " is corrupt: neighbor " + to_string((long long)w) + " is not a vertex");
+                }
+            }
+            return g;
+        }
+
+        // A method that returns the bytes used by the offsets and neighbor arrays
+        size_t memoryBytes() const {
+            return offsets.capacity() * sizeof(long long) + neighbors.capacity() * sizeof(T);
+        }
+
+        // A method that prints all vertices and their adjacency lists in the graph
+        void print() const {
+            for (int i = 0; i < numVertices; i++) { // Loop through all vertices in the graph
+                cout << i << ": "; // Print the current vertex
+                for (long long j = offsets[i]; j < offsets[i + 1]; j++) { // Loop through the adjacency list of the current vertex
+                    cout << neighbors[j] << " "; // Print each adjacent vertex
+                }
+                cout << endl;
+            }
+        }
+
+        // A method that performs an iterative depth-first traversal from a given vertex, calling visit on each vertex in the
+        // same order as a recursive traversal would; a visitor that returns false stops the traversal early
+        template <class Visitor>
+        void dfs(int v, Visitor visit) const {
+            VisitMarks& marks = csr_traversal_scratch().marks;
+            vector<pair<int, long long>>& dfsStack = csr_traversal_scratch().dfsStack;
+            marks.begin(numVertices); // Start a new generation instead of allocating fresh visited flags
+            dfsStack.clear();
+            marks.visit(v);
+            if (!call_visitor(visit, v)) {
+                return;
+            }
+            dfsStack.push_back(make_pair(v, offsets[v]));
+            while (!dfsStack.empty()) { // Loop until every branch has been explored
+                int u = dfsStack.back().first;
+                long long& next = dfsStack.back().second; // The position of the next neighbor of u to look at
+                if (next < offsets[u + 1]) {
+                    T w = neighbors[next++];
+                    if (marks.visit(w)) { // Descend into the first unvisited neighbor, as the recursive version would
+                        if (!call_visitor(visit, w)) {
+                            return;
+                        }
+                        dfsStack.push_back(make_pair((int)w, offsets[w]));
+                    }
+                }
+                else { // Every neighbor of u is done, so backtrack
+                    dfsStack.pop_back();
+                }
+            }
+        }
+
+        // A method that performs a breadth-first traversal from a given vertex, calling visit on each vertex in the order it is
+        // dequeued; a visitor that returns false stops the traversal early
+        template <class Visitor>
+        void bfs(int v, Visitor visit) const {
+            VisitMarks& marks = csr_traversal_scratch().marks;
+            vector<int>& bfsQueue = csr_traversal_scratch().bfsQueue;
+            marks.begin(numVertices); // Start a new generation instead of allocating fresh visited flags
+            bfsQueue.clear();
+            bfsQueue.push_back(v);
+            marks.visit(v);
+            for (size_t head = 0; head < bfsQueue.size(); head++) { // The vector doubles as the queue, read from head onwards
+                int u = bfsQueue[head];
+                if (!call_visitor(visit, u)) {
+                    return;
+                }
+                for (long long i = offsets[u]; i < offsets[u + 1]; i++) { // Loop through the adjacent vertices of the dequeued vertex
+                    if (marks.visit(neighbors[i])) { // Enqueue each adjacent vertex the first time it is seen
+                        bfsQueue.push_back(neighbors[i]);
+                    }
+                }
+            }
+        }
+
+        // A method that returns the vertices in depth-first order from a given vertex
+        vector<int> dfsOrder(int v) const {
+            vector<int> order;
+            dfs(v, [&order](int u) { order.push_back(u); });
+            return order;
+        }
+
+        // A method that returns the vertices in breadth-first order from a given vertex
+        vector<int> bfsOrder(int v) const {
+            vector<int> order;
+            bfs(v, [&order](int u) { order.push_back(u); });
+            return order;
+        }
+
+        // A method that performs a depth-first traversal from a given vertex in the graph and prints all visited vertices
+        void dfs(int v) const {
+            dfs(v, [](int u) { cout << u << " "; }); // Print each vertex as it is visited
+            cout << endl;
+        }
+
+        // A method that performs a breadth-first traversal from a given vertex in the graph and prints all visited vertices
+        void bfs(int v) const {
+            bfs(v, [](int u) { cout << u << " "; }); // Print each vertex as it is dequeued
+            cout << endl;
+        }
+
+        // A method that performs a parallel direction-optimizing breadth-first search from a given vertex (Beamer's algorithm).
+        // Small frontiers are expanded top-down from a queue; once the frontier's edges outnumber a share of the unexplored edges,
+        // every unvisited vertex instead looks for a parent in a frontier bitmap, which checks far fewer edges on large frontiers.
+        // Throws out_of_range if the source is not a vertex of the graph.
+        BfsResult parallelBfs(int source, int threads = 0) const {
+            if (source < 0 || source >= numVertices) {
+                throw out_of_range("Vertex " + to_string(source) + " is not in the graph");
+            }
+            if (threads <= 0) {
+                threads = max(1, (int)thread::hardware_concurrency());
+            }
+            const int n = numVertices;
+            const int words = (n + 63) / 64; // One bit per vertex, 64 vertices per word
+            const long long alpha = 14; // Go bottom-up when the frontier's edges exceed 1 / alpha of the unexplored edges
+            const long long beta = 24; // Go back top-down when the frontier holds fewer than 1 / beta of the vertices
+            const long long serialWork = 1 << 14; // Below this many edges a step runs on the calling thread only
+
+            BfsResult result;
+            result.parent.assign(n, -1);
+            result.distance.assign(n, -1);
+            vector<atomic<uint64_t>> visited(words);
+            for (int w = 0; w < words; w++) {
+                visited[w].store(0, memory_order_relaxed);
+            }
+            vector<uint64_t> frontierBits(words, 0); // The frontier as a bitmap, used by bottom-up steps
+            vector<uint64_t> nextBits(words, 0);
+            vector<int> frontier; // The frontier as a list, used by top-down steps
+
+            result.parent[source] = source;
+            result.distance[source] = 0;
+            visited[source >> 6].fetch_or(1ULL << (source & 63), memory_order_relaxed);
+            frontier.push_back(source);
+            long long frontierSize = 1;
+            long long frontierEdges = degree(source);
+            long long unexploredEdges = (long long)neighbors.size() - frontierEdges;
+            bool bottomUp = false;
+            int level = 0;
+
+            while (frontierSize > 0) {
+                if (!bottomUp && !directed && frontierEdges > unexploredEdges / alpha) { // Switch to bottom-up: list to bitmap
+                    fill(frontierBits.begin(), frontierBits.end(), 0);
+                    for (int v : frontier) {
+                        frontierBits[v >> 6] |= 1ULL << (v & 63);
+                    }
+                    bottomUp = true;
+                }
+                else if (bottomUp && frontierSize < n / beta) { // Switch back to top-down: bitmap to list
+                    frontier.clear();
+                    for (int w = 0; w < words; w++) {
+                        for (uint64_t bits = frontierBits[w]; bits != 0; bits &= bits - 1) {
+                            frontier.push_back(w * 64 + __builtin_ctzll(bits));
+                        }
+                    }
+                    bottomUp = false;
+                }
+
+                int stepThreads = frontierEdges < serialWork ? 1 : threads;
+                vector<long long> foundCount(stepThreads, 0); // Vertices each thread added to the next frontier
+                vector<long long> foundEdges(stepThreads, 0); // The degrees of those vertices
+
+                if (bottomUp) {
+                    // Every thread owns a whole-word range of vertices, so it is the only writer of those next-frontier words
+                    run_parallel(stepThreads, [&](int t) {
+                        int firstWord = (int)((long long)words * t / stepThreads);
+                        int lastWord = (int)((long long)words * (t + 1) / stepThreads);
+                        for (int w = firstWord; w < lastWord; w++) {
+                            uint64_t unvisited = ~visited[w].load(memory_order_relaxed);
+                            uint64_t found = 0;
+                            for (; unvisited != 0; unvisited &= unvisited - 1) {
+                                int v = w * 64 + __builtin_ctzll(unvisited);
+                                if (v >= n) {
+                                    break;
+                                }
+                                for (long long i = offsets[v]; i < offsets[v + 1]; i++) { // Look for any neighbor in the frontier
+                                    T u = neighbors[i];
+                                    if (frontierBits[u >> 6] & (1ULL << (u & 63))) {
+                                        result.parent[v] = u;
+                                        result.distance[v] = level + 1;
+                                        found |= 1ULL << (v & 63);
+                                        foundCount[t]++;
+                                        foundEdges[t] += offsets[v + 1] - offsets[v];
+                                        break; // One parent is enough, skip the rest of the edges
+                                    }
+                                }
+                            }
+                            nextBits[w] = found;
+                            if (found != 0) {
+                                visited[w].fetch_or(found, memory_order_relaxed);
+                            }
+                        }
+                    });
+                    frontierBits.swap(nextBits);
+                }
+                else {
+                    // Every thread expands a slice of the frontier; claiming a vertex is an atomic bit set, so each is added once
+                    vector<vector<int>> next(stepThreads);
+                    run_parallel(stepThreads, [&](int t) {
+                        size_t first = frontier.size() * t / stepThreads;
+                        size_t last = frontier.size() * (t + 1) / stepThreads;
+                        for (size_t f = first; f < last; f++) {
+                            int u = frontier[f];
+                            for (long long i = offsets[u]; i < offsets[u + 1]; i++) {
+                                T v = neighbors[i];
+                                uint64_t bit = 1ULL << (v & 63);
+                                if ((visited[v >> 6].load(memory_order_relaxed) & bit) == 0
+                                    && (visited[v >> 6].fetch_or(bit, memory_order_relaxed) & bit) == 0) { // Check before the atomic to skip most of them
+                                    result.parent[v] = u;
+                                    result.distance[v] = level + 1;
+                                    next[t].push_back(v);
+                                    foundEdges[t] += offsets[v + 1] - offsets[v];
+                                }
+                            }
+                        }
+                        foundCount[t] = (long long)next[t].size();
+                    });
+                    frontier.clear();
+                    for (int t = 0; t < stepThreads; t++) {
+                        frontier.insert(frontier.end(), next[t].begin(), next[t].end());
+                    }
+                }
+
+                frontierSize = 0;
+                frontierEdges = 0;
+                for (int t = 0; t < stepThreads; t++) {
+                    frontierSize += foundCount[t];
+                    frontierEdges += foundEdges[t];
+                }
+                unexploredEdges -= frontierEdges;
+                level++;
+            }
+
+            result.edgesTraversed = 0;
+            for (int v = 0; v < n; v++) {
+                if (result.distance[v] != -1) {
+                    result.edgesTraversed += degree(v);
+                }
+            }
+            if (!directed) { // Every undirected edge is stored from both ends
+                result.edgesTraversed /= 2;
+            }
+            return result;
+        }
+
+        // A method that runs one multi-source breadth-first search (Then et al.'s MS-BFS) from up to 64 sources at once. Every
+        // vertex carries a 64-bit word with one bit per source, so one scan of a vertex's neighbors advances every search that
+        // has it on its frontier, and searches that overlap share all of that work. reached(v, bits, level) is called when the
+        // sources in bits first reach v, at the given number of hops; a negative maxHops means no limit. After the call,
+        // workspace.seen[v] still holds the sources that reached v, until the next batch on the same workspace.
+        template <class Reached>
+        void multiSourceBfs(const int* sources, int count, int maxHops, MsBfsWorkspace& workspace, Reached reached) const {
+            if (count > 64) {
+                throw invalid_argument("A multi-source search batch holds at most 64 sources");
+            }
+            if ((int)workspace.seen.size() != numVertices) {
+                workspace.seen.assign(numVertices, 0);
+                workspace.visit.assign(numVertices, 0);
+                workspace.visitNext.assign(numVertices, 0);
+                workspace.touched.clear();
+            }
+            for (int v : workspace.touched) { // Forget the previous batch in time proportional to what it reached
+                workspace.seen[v] = 0;
+            }
+            workspace.touched.clear();
+            workspace.frontier.clear();
+            for (int i = 0; i < count; i++) {
+                int s = sources[i];
+                if (workspace.seen[s] == 0) {
+                    workspace.touched.push_back(s);
+                    workspace.frontier.push_back(s); // Several sources may share a vertex
+                }
+                workspace.seen[s] |= 1ULL << i;
+                workspace.visit[s] |= 1ULL << i;
+            }
+            for (int v : workspace.frontier) {
+                reached(v, workspace.visit[v], 0);
+            }
+            for (int level = 1; !workspace.frontier.empty() && (maxHops < 0 || level <= maxHops); level++) {
+                workspace.nextFrontier.clear();
+                for (int v : workspace.frontier) {
+                    uint64_t bits = workspace.visit[v];
+                    workspace.visit[v] = 0;
+                    for (long long i = offsets[v]; i < offsets[v + 1]; i++) {
+                        T w = neighbors[i];
+                        uint64_t fresh = bits & ~workspace.seen[w]; // The searches that have not reached w yet
+                        if (fresh != 0) {
+                            if (workspace.visitNext[w] == 0) {
+                                workspace.nextFrontier.push_back(w);
+                            }
+                            workspace.visitNext[w] |= fresh;
+                        }
+                    }
+                }
+                for (int w : workspace.nextFrontier) { // Mark the new level seen only now, so every frontier vertex saw the same state
+                    uint64_t bits = workspace.visitNext[w];
+                    workspace.visitNext[w] = 0;
+                    if (workspace.seen[w] == 0) {
+                        workspace.touched.push_back(w);
+                    }
+                    workspace.seen[w] |= bits;
+                    workspace.visit[w] = bits;
+                    reached(w, bits, level);
+                }
+                swap(workspace.frontier, workspace.nextFrontier);
+            }
+            for (int v : workspace.frontier) { // A hop limit can leave a frontier behind
+                workspace.visit[v] = 0;
+            }
+        }
+
+        // A helper method that sorts sources by id, splits them into batches of 64 and runs batch(index, batchSources, count,
+        // workspace) for each on several threads (0 for all cores), where index[i] is the position of batchSources[i] in the
+        // caller's list. Nearby ids are often nearby vertices, so sorting makes the searches in a batch overlap and share work.
+        template <class Batch>
+        void forEachSourceBatch(const vector<int>& sources, int threads, Batch batch) const {
+            if (threads <= 0) {
+                threads = max(1, (int)thread::hardware_concurrency());
+            }
+            vector<size_t> index(sources.size());
+            for (size_t i = 0; i < sources.size(); i++) {
+                index[i] = i;
+            }
+            stable_sort(index.begin(), index.end(), [&sources](size_t a, size_t b) { return sources[a] < sources[b]; });
+            vector<int> sorted(sources.size());
+            for (size_t i = 0; i < sources.size(); i++) {
+                sorted[i] = sources[index[i]];
+            }
+            size_t batches = (sources.size() + 63) / 64;
+            threads = (int)max((size_t)1, min((size_t)threads, batches));
+            run_parallel(threads, [&](int t) {
+                MsBfsWorkspace& workspace = csr_traversal_scratch().msBfs; // Each worker searches in its own thread's workspace
+                for (size_t b = t; b < batches; b += threads) {
+                    size_t first = b * 64;
+                    batch(index.data() + first, sorted.data() + first, (int)min((size_t)64, sources.size() - first), workspace);
+                }
+            });
+        }
+
+        // A method that returns the hop distance from each of the given sources to every vertex (-1 if unreachable, or farther
+        // than maxHops when it is not negative), as one row per source
+        vector<vector<int>> multiSourceDistances(const vector<int>& sources, int maxHops = -1, int threads = 0) const {
+            vector<vector<int>> distance(sources.size());
+            forEachSourceBatch(sources, threads, [&](const size_t* index, const int* batchSources, int count, MsBfsWorkspace& workspace) {
+                for (int i = 0; i < count; i++) {
+                    distance[index[i]].assign(numVertices, -1);
+                }
+                multiSourceBfs(batchSources, count, maxHops, workspace, [&](int v, uint64_t bits, int level) {
+                    for (; bits != 0; bits &= bits - 1) {
+                        distance[index[__builtin_ctzll(bits)]][v] = level;
+                    }
+                });
+            });
+            return distance;
+        }
+
+        // A method that returns, for each of the given sources, the number of vertices within k hops of it (itself included)
+        vector<long long> kHopCounts(const vector<int>& sources, int k, int threads = 0) const {
+            vector<long long> counts(sources.size(), 0);
+            forEachSourceBatch(sources, threads, [&](const size_t* index, const int* batchSources, int count, MsBfsWorkspace& workspace) {
+                long long batchCounts[64] = {0};
+                multiSourceBfs(batchSources, count, k, workspace, [&batchCounts](int, uint64_t bits, int) {
+                    for (; bits != 0; bits &= bits - 1) {
+                        batchCounts[__builtin_ctzll(bits)]++;
+                    }
+                });
+                for (int i = 0; i < count; i++) {
+                    counts[index[i]] = batchCounts[i];
+                }
+            });
+            return counts;
+        }
+
+        // A method that answers a batch of reachability queries (can the second vertex be reached from the first?). Queries are
+        // grouped by source, so every distinct source is searched once and 64 of them share each search.
+        vector<char> reachable(const vector<pair<int,int>>& queries, int threads = 0) const {
+            vector<size_t> order(queries.size()); // The query indexes sorted by source
+            for (size_t q = 0; q < queries.size(); q++) {
+                order[q] = q;
+            }
+            std::sort(order.begin(), order.end(), [&queries](size_t a, size_t b) { return queries[a].first < queries[b].first; });
+            vector<int> sources; // The distinct sources in sorted order, which forEachSourceBatch keeps as they are
+            vector<size_t> firstQuery; // Where each distinct source's queries start in order, plus an end marker
+            for (size_t i = 0; i < order.size(); i++) {
+                if (i == 0 || queries[order[i]].first != queries[order[i - 1]].first) {
+                    sources.push_back(queries[order[i]].first);
+                    firstQuery.push_back(i);
+                }
+            }
+            firstQuery.push_back(order.size());
+
+            vector<char> answer(queries.size(), 0);
+            forEachSourceBatch(sources, threads, [&](const size_t* index, const int* batchSources, int count, MsBfsWorkspace& workspace) {
+                multiSourceBfs(batchSources, count, -1, workspace, [](int, uint64_t, int) {});
+                for (int i = 0; i < count; i++) { // The seen words still hold this batch's result
+                    for (size_t j = firstQuery[index[i]]; j < firstQuery[index[i] + 1]; j++) {
+                        answer[order[j]] = (workspace.seen[queries[order[j]].second] >> i) & 1;
+                    }
+                }
+            });
+            return answer;
+        }
+
+        // A method that times k-hop counting from a number of random sources, first with one breadth-first search per source and
+        // then with multi-source searches, both on one thread, and returns {one-at-a-time microseconds, batched microseconds}
+        vector<int> get_khop_time_taken(int queries, int k, unsigned seed = 1) const {
+            mt19937 rng(seed);
+            uniform_int_distribution<int> vertex(0, numVertices - 1);
+            vector<int> sources(queries);
+            for (int& s : sources) {
+                s = vertex(rng);
+            }
+            volatile long long sink = 0; // Keeps the counts alive so the searches are not optimized away
+            vector<int>& bfsQueue = csr_traversal_scratch().bfsQueue;
+
+            auto start = chrono::high_resolution_clock::now();
+            vector<int> hops(numVertices, -1);
+            for (int s : sources) { // A level-bounded queue search per source, clearing only what it reached
+                bfsQueue.clear();
+                bfsQueue.push_back(s);
+                hops[s] = 0;
+                for (size_t head = 0; head < bfsQueue.size(); head++) {
+                    int u = bfsQueue[head];
+                    if (hops[u] == k) {
+                        continue;
+                    }
+                    for (long long i = offsets[u]; i < offsets[u + 1]; i++) {
+                        if (hops[neighbors[i]] < 0) {
+                            hops[neighbors[i]] = hops[u] + 1;
+                            bfsQueue.push_back(neighbors[i]);
+                        }
+                    }
+                }
+                sink = sink + (long long)bfsQueue.size();
+                for (int v : bfsQueue) {
+                    hops[v] = -1;
+                }
+            }
+            auto stop = chrono::high_resolution_clock::now();
+            int single = chrono::duration_cast<chrono::microseconds>(stop - start).count();
+
+            start = chrono::high_resolution_clock::now();
+            vector<long long> counts = kHopCounts(sources, k, 1);
+            sink = counts.empty() ? 0 : counts.back();
+            stop = chrono::high_resolution_clock::now();
+            int batched = chrono::duration_cast<chrono::microseconds>(stop - start).count();
+            return {single, batched};
+        }
+
+        // A method that times the parallel search at 1, 2, 4, ... threads up to maxThreads (all cores by default)
+        // and returns one row of {threads, seconds, traversed edges per second} per thread count
+        vector<vector<double>> get_teps(int source, int maxThreads = 0) const {
+            if (maxThreads <= 0) {
+                maxThreads = max(1, (int)thread::hardware_concurrency());
+            }
+            vector<int> counts;
+            for (int threads = 1; threads < maxThreads; threads *= 2) {
+                counts.push_back(threads);
+            }
+            counts.push_back(maxThreads);
+
+            vector<vector<double>> rows;
+            for (int threads : counts) {
+                auto start = chrono::high_resolution_clock::now();
+                BfsResult r = parallelBfs(source, threads);
+                auto stop = chrono::high_resolution_clock::now();
+                double seconds = chrono::duration<double>(stop - start).count();
+                rows.push_back({(double)threads, seconds, seconds > 0 ? r.edgesTraversed / seconds : 0.0});
+            }
+            return rows;
+        }
+};
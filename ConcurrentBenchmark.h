@@ -0,0 +1,350 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "ToArray.h"
+#include "SortedArray.h"
+#include "Stack.h"
+#include "Queue.h"
+#include "LinkedList.h"
+#include "Hash Table.h"
+#include "BST.h"
+#include "ConcurrentHashTable.h"
+#include "ConcurrentStack.h"
+#include "ConcurrentQueue.h"
+using namespace std;
+
+// The concurrent benchmark mode runs the API's mixed operation stream against one container from several
+// threads at once. Containers without a concurrent variant are wrapped in a lock; the native concurrent
+// variants are used where they support every operation in the API. sort() is left out of the mixed stream
+// because a whole-container operation serializes every thread, and it is already timed by get_time_taken.
+
+// The kinds of operation in the mixed stream
+enum class OpKind { Insert, Delete, Search, Size };
+
+// One operation of the mixed stream
+struct Operation {
+    OpKind kind;
+    int key;
+};
+
+// The result of running one container at one thread count
+struct ConcurrentResult {
+    string data_structure; // The name of the container, as its traits register it
+    int threads; // The number of threads that ran the stream
+    long long ops_per_second; // The combined throughput of all threads
+    vector<long long> p99_per_thread; // Each thread's 99th percentile operation latency, in nanoseconds
+    long long p50_latency; // The median operation latency over all threads, in nanoseconds
+    long long p99_latency; // The worst of the threads' 99th percentile latencies, in nanoseconds
+    long long lock_wait; // The total time all threads spent waiting to acquire the lock, in nanoseconds
+    double lock_wait_share; // lock_wait as a fraction of the total time spent in operations
+};
+
+// A function that builds a mixed stream of count operations over keyRange keys from the methods named in the API
+inline vector<Operation> make_operation_stream(const vector<string>& api, long long count, int keyRange, unsigned seed) {
+    vector<OpKind> kinds;
+    for (const string& method : api) {
+        if (method == "insert()") kinds.push_back(OpKind::Insert);
+        else if (method == "delete()") kinds.push_back(OpKind::Delete);
+        else if (method == "search()") kinds.push_back(OpKind::Search);
+        else if (method == "size()") kinds.push_back(OpKind::Size);
+    }
+    if (kinds.empty()) { // Nothing to mix, so default to lookups
+        kinds.push_back(OpKind::Search);
+    }
+    vector<Operation> stream(count);
+    unsigned state = seed | 1u; // A xorshift generator so each thread gets its own reproducible stream
+    for (long long i = 0; i < count; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        stream[i].kind = kinds[state % kinds.size()];
+        stream[i].key = (int)((state >> 8) % (unsigned)keyRange);
+    }
+    return stream;
+}
+
+// Functions that apply one operation to each non-concurrent container (the caller holds the lock)
+inline void apply_operation(ToArray<int>& c, const Operation& op) {
+    if (op.kind == OpKind::Insert) c.append(op.key);
+    else if (op.kind == OpKind::Delete) { if (!c.isEmpty()) c.remove(c.getSize() - 1); }
+    else if (op.kind == OpKind::Search) benchmark_sink = c.search(op.key);
+    else benchmark_sink = c.getSize();
+}
+
+inline void apply_operation(SortedArray<int>& c, const Operation& op) {
+    if (op.kind == OpKind::Insert) c.insert(op.key);
+    else if (op.kind == OpKind::Delete) c.remove(op.key);
+    else if (op.kind == OpKind::Search) benchmark_sink = c.search(op.key);
+    else benchmark_sink = c.getSize();
+}
+
+inline void apply_operation(Stack<int>& c, const Operation& op) {
+    if (op.kind == OpKind::Insert) c.push(op.key);
+    else if (op.kind == OpKind::Delete) { if (!c.isEmpty()) c.pop(); }
+    else if (op.kind == OpKind::Search) benchmark_sink = c.search(op.key);
+    else benchmark_sink = c.getSize();
+}
+
+inline void apply_operation(DynamicQueue<int>& c, const Operation& op) {
+    if (op.kind == OpKind::Insert) c.enqueue(op.key);
+    else if (op.kind == OpKind::Delete) { if (!c.isEmpty()) c.dequeue(); }
+    else if (op.kind == OpKind::Search) benchmark_sink = c.search(op.key);
+    else benchmark_sink = c.getSize();
+}
+
+inline void apply_operation(LinkedList<int>& c, const Operation& op) {
+    if (op.kind == OpKind::Insert) c.append(op.key);
+    else if (op.kind == OpKind::Delete) { if (!c.isEmpty()) c.remove(0); }
+    else if (op.kind == OpKind::Search) benchmark_sink = c.search(op.key);
+    else benchmark_sink = c.getSize();
+}
+
+inline void apply_operation(BST<int>& c, const Operation& op) {
+    if (op.kind == OpKind::Insert) c.insert(op.key);
+    else if (op.kind == OpKind::Delete) c.remove(op.key);
+    else if (op.kind == OpKind::Search) benchmark_sink = c.search(op.key);
+    else benchmark_sink = c.search(0); // BST keeps no size, so a lookup stands in for size()
+}
+
+// A class template that wraps a non-concurrent container in a lock, timing how long each operation waits for it.
+// With a shared_mutex, search() and size() take the lock in shared mode so readers proceed together.
+template <class Container, class Mutex>
+class LockedContainer {
+    private:
+        Container container; // The wrapped container
+        Mutex lock; // The lock serializing access to it
+
+    public:
+        // A method that gives direct access to the container for prefilling before any thread starts
+        Container& get() {
+            return container;
+        }
+
+        // A method that applies one operation under the lock and adds the time spent acquiring it to waitNs
+        void apply(const Operation& op, long long& waitNs) {
+            bool readOnly = op.kind == OpKind::Search || op.kind == OpKind::Size;
+            auto start = chrono::steady_clock::now();
+            if constexpr (is_same<Mutex, shared_mutex>::value) {
+                if (readOnly) {
+                    shared_lock<shared_mutex> guard(lock);
+                    waitNs += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+                    apply_operation(container, op);
+                    return;
+                }
+            }
+            lock_guard<Mutex> guard(lock);
+            waitNs += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+            apply_operation(container, op);
+        }
+};
+
+// A class that adapts ConcurrentHashTable to the benchmark's apply interface
+class NativeHashTableTarget {
+    private:
+        ConcurrentHashTable<int,int> table;
+
+    public:
+        ConcurrentHashTable<int,int>& get() {
+            return table;
+        }
+
+        void apply(const Operation& op, long long&) {
+            int value;
+            if (op.kind == OpKind::Insert) table.insert(op.key, op.key);
+            else if (op.kind == OpKind::Delete) table.remove(op.key);
+            else if (op.kind == OpKind::Search) benchmark_sink = table.search(op.key, value);
+            else benchmark_sink = table.getSize();
+        }
+};
+
+// A class that adapts ConcurrentStack to the benchmark's apply interface (used only when the API has no search() or size())
+class NativeStackTarget {
+    private:
+        ConcurrentStack<int> stack;
+
+    public:
+        ConcurrentStack<int>& get() {
+            return stack;
+        }
+
+        void apply(const Operation& op, long long&) {
+            int value;
+            if (op.kind == OpKind::Insert) stack.push(op.key);
+            else stack.pop(value);
+        }
+};
+
+// A class that adapts MpmcQueue to the benchmark's apply interface (used only when the API has no search() or size())
+class NativeQueueTarget {
+    private:
+        MpmcQueue<int> queue;
+
+    public:
+        NativeQueueTarget() : queue(1 << 20) {}
+
+        MpmcQueue<int>& get() {
+            return queue;
+        }
+
+        void apply(const Operation& op, long long&) {
+            int value;
+            if (op.kind == OpKind::Insert) queue.tryEnqueue(op.key);
+            else queue.tryDequeue(value);
+        }
+};
+
+// A helper function that returns the value at a given percentile of a list of latencies (the list is reordered)
+inline long long latency_percentile(vector<long long>& samples, double percentile) {
+    if (samples.empty()) {
+        return 0;
+    }
+    size_t index = (size_t)(percentile * (samples.size() - 1));
+    nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+// A function template that runs each thread's operation stream against one target and gathers throughput, latency and lock wait
+template <class Target>
+ConcurrentResult run_concurrent(Target& target, const string& name, const vector<string>& api, int threads, long long opsPerThread, int keyRange) {
+    vector<vector<Operation>> streams(threads);
+    for (int t = 0; t < threads; t++) { // Build the streams before starting the clock
+        streams[t] = make_operation_stream(api, opsPerThread, keyRange, 2463534242u + (unsigned)t * 7919u);
+    }
+    vector<vector<long long>> latencies(threads, vector<long long>(opsPerThread));
+    vector<long long> waits(threads, 0);
+    vector<thread> workers;
+
+    auto start = chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(thread([&, t]() {
+            const vector<Operation>& stream = streams[t];
+            vector<long long>& latency = latencies[t];
+            long long wait = 0;
+            for (long long i = 0; i < opsPerThread; i++) {
+                auto before = chrono::steady_clock::now();
+                target.apply(stream[i], wait);
+                latency[i] = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - before).count();
+            }
+            waits[t] = wait;
+        }));
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    auto stop = chrono::steady_clock::now();
+
+    ConcurrentResult result;
+    result.data_structure = name;
+    result.threads = threads;
+    long long elapsed = chrono::duration_cast<chrono::microseconds>(stop - start).count();
+    long long ops = opsPerThread * threads;
+    result.ops_per_second = elapsed == 0 ? ops * 1000000 : ops * 1000000 / elapsed;
+
+    vector<long long> all; // Every latency sample, for the overall median
+    long long busy = 0; // The total time spent inside operations
+    for (int t = 0; t < threads; t++) {
+        for (long long l : latencies[t]) {
+            busy += l;
+        }
+        all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+        result.p99_per_thread.push_back(latency_percentile(latencies[t], 0.99));
+    }
+    result.p50_latency = latency_percentile(all, 0.50);
+    result.p99_latency = *max_element(result.p99_per_thread.begin(), result.p99_per_thread.end());
+    result.lock_wait = 0;
+    for (long long w : waits) {
+        result.lock_wait += w;
+    }
+    result.lock_wait_share = busy == 0 ? 0.0 : (double)result.lock_wait / (double)busy;
+    return result;
+}
+
+// A function template that prefills a target with every other key so searches and deletes find work, then runs it
+template <class Target, class Fill>
+ConcurrentResult prefill_and_run(Target& target, Fill fill, const string& name, const vector<string>& api, int threads, long long opsPerThread, int keyRange) {
+    for (int k = 0; k < keyRange; k += 2) {
+        fill(target, k);
+    }
+    return run_concurrent(target, name, api, threads, opsPerThread, keyRange);
+}
+
+// A helper function that checks whether an API only pushes and pops, so a native stack or queue can serve it
+inline bool api_is_push_pop_only(const vector<string>& api) {
+    for (const string& method : api) {
+        if (method == "search()" || method == "size()") {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A function that benchmarks one named container at one thread count, choosing a native concurrent variant where one fits
+// and otherwise wrapping it in a reader-writer lock
+inline ConcurrentResult get_concurrent_result(const string& ds, const vector<string>& api, int threads, long long opsPerThread, int keyRange) {
+    auto apply = [](auto& target, int key) { apply_operation(target.get(), Operation{OpKind::Insert, key}); };
+    if (ds == "hash table") {
+        NativeHashTableTarget target;
+        return prefill_and_run(target, [](NativeHashTableTarget& t, int key) { t.get().insert(key, key); }, ds, api, threads, opsPerThread, keyRange);
+    }
+    else if (ds == "stack" && api_is_push_pop_only(api) && threads <= ConcurrentStack<int>::maxThreads()) { // Past the hazard slots, lock instead
+        NativeStackTarget target;
+        return prefill_and_run(target, [](NativeStackTarget& t, int key) { t.get().push(key); }, ds, api, threads, opsPerThread, keyRange);
+    }
+    else if (ds == "queue" && api_is_push_pop_only(api)) {
+        NativeQueueTarget target;
+        return prefill_and_run(target, [](NativeQueueTarget& t, int key) { t.get().tryEnqueue(key); }, ds, api, threads, opsPerThread, keyRange);
+    }
+    else if (ds == "array") {
+        LockedContainer<ToArray<int>, shared_mutex> target;
+        return prefill_and_run(target, apply, ds, api, threads, opsPerThread, keyRange);
+    }
+    else if (ds == "sorted array") {
+        LockedContainer<SortedArray<int>, shared_mutex> target;
+        return prefill_and_run(target, apply, ds, api, threads, opsPerThread, keyRange);
+    }
+    else if (ds == "stack") {
+        LockedContainer<Stack<int>, shared_mutex> target;
+        return prefill_and_run(target, apply, ds, api, threads, opsPerThread, keyRange);
+    }
+    else if (ds == "queue") {
+        LockedContainer<DynamicQueue<int>, shared_mutex> target;
+        return prefill_and_run(target, apply, ds, api, threads, opsPerThread, keyRange);
+    }
+    else if (ds == "linked list") {
+        LockedContainer<LinkedList<int>, shared_mutex> target;
+        return prefill_and_run(target, apply, ds, api, threads, opsPerThread, keyRange);
+    }
+    else if (ds == "BST") {
+        LockedContainer<BST<int>, shared_mutex> target;
+        return prefill_and_run(target, apply, ds, api, threads, opsPerThread, keyRange);
+    }
+    throw invalid_argument("No concurrent benchmark for " + ds);
+}
+
+// A function that runs one container at 1, 2, 4, ... threads up to maxThreads and returns one result per thread count
+inline vector<ConcurrentResult> get_scaling_curve(const string& ds, const vector<string>& api, int maxThreads, long long opsPerThread, int keyRange = 10000) {
+    vector<ConcurrentResult> curve;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        curve.push_back(get_concurrent_result(ds, api, threads, opsPerThread, keyRange));
+        if (threads < maxThreads && threads * 2 > maxThreads) { // Always finish on the requested thread count
+            curve.push_back(get_concurrent_result(ds, api, maxThreads, opsPerThread, keyRange));
+        }
+    }
+    return curve;
+}
+
+// A function that prints a scaling curve with its throughput, tail latency and lock wait at every thread count
+inline void print_scaling_curve(const vector<ConcurrentResult>& curve) {
+    for (const ConcurrentResult& r : curve) {
+        cout << r.data_structure << " @ " << r.threads << " threads: " << r.ops_per_second << " ops/s, p50 "
+             << r.p50_latency << " ns, p99 " << r.p99_latency << " ns, lock wait " << (int)(r.lock_wait_share * 100) << "%" << endl;
+    }
+}
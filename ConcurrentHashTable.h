@@ -0,0 +1,255 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <list>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <chrono>
+#include <functional>
+#include <utility>
+#include <stdexcept>
+#include "Hash Table.h"
+using namespace std;
+
+// A class template for concurrent hash tables split into independently locked shards, each using separate chaining
+template <class K, class V>
+class ConcurrentHashTable {
+    private:
+        // A shard of the table with its own lock and buckets, aligned so neighbouring shard headers never share a cache line
+        struct alignas(64) Shard {
+            mutable shared_mutex lock; // Shared for reads, exclusive for writes
+            vector<list<HashNode<K,V>>> table; // The vector of lists to store the nodes of this shard
+            int size; // The current number of nodes in this shard
+        };
+
+        vector<Shard> shards; // The shards, a power of two of them
+        int shardMask; // The number of shards minus one, used to pick a shard with a bitwise and
+        int shardBits; // The number of low hash bits used to pick the shard
+        double maxLoadFactor; // The nodes per bucket above which a shard doubles its buckets
+
+        // A helper method that returns the full hash value of a given key
+        size_t hashFunction(const K& key) const {
+            return hash<K>()(key);
+        }
+
+        // A helper method that returns the shard a hash value belongs to
+        int shardOf(size_t h) const {
+            return (int)(h & (size_t)shardMask);
+        }
+
+        // A helper method that returns the bucket a hash value belongs to within a shard with a given number of buckets
+        int bucketOf(size_t h, size_t buckets) const {
+            return (int)((h >> shardBits) % buckets); // Skip the bits used for the shard, so every bucket gets used
+        }
+
+        // A helper method that doubles the buckets of one shard and redistributes its nodes (the caller holds the exclusive lock)
+        void rehash(Shard& shard) {
+            vector<list<HashNode<K,V>>> bigger(shard.table.size() * 2);
+            for (auto& bucket : shard.table) {
+                while (!bucket.empty()) {
+                    auto& target = bigger[bucketOf(hashFunction(bucket.front().key), bigger.size())];
+                    target.splice(target.begin(), bucket, bucket.begin()); // Move the node without reallocating it
+                }
+            }
+            shard.table.swap(bigger);
+        }
+
+        // A helper method that inserts or updates a node in one shard (the caller holds the exclusive lock)
+        void insertLocked(Shard& shard, size_t h, const K& key, const V& value) {
+            auto& bucket = shard.table[bucketOf(h, shard.table.size())];
+            for (auto& node : bucket) { // Loop through the nodes in the bucket
+                if (node.key == key) { // Update the value if the key already exists
+                    node.value = value;
+                    return;
+                }
+            }
+            bucket.push_front(HashNode<K,V>(key, value));
+            shard.size++;
+            if (shard.size > maxLoadFactor * shard.table.size()) { // Only this shard grows; the others keep serving
+                rehash(shard);
+            }
+        }
+
+        // A helper method that looks up a key in one shard (the caller holds at least the shared lock)
+        bool searchLocked(const Shard& shard, size_t h, const K& key, V& value) const {
+            for (auto& node : shard.table[bucketOf(h, shard.table.size())]) { // Loop through the nodes in the bucket
+                if (node.key == key) {
+                    value = node.value;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // A helper method that sorts the positions of a batch of keys by shard, so each shard lock is taken once
+        vector<vector<int>> groupByShard(const vector<size_t>& hashes) const {
+            vector<vector<int>> groups(shards.size());
+            for (int i = 0; i < (int)hashes.size(); i++) {
+                groups[shardOf(hashes[i])].push_back(i);
+            }
+            return groups;
+        }
+
+    public:
+        // A constructor that creates a table with a number of shards (rounded up to a power of two) and initial buckets per shard.
+        // Throws invalid_argument if the load factor is not positive, since every insert would then rehash its shard.
+        ConcurrentHashTable(int shardCount = 64, int bucketsPerShard = 16, double loadFactor = 1.0) {
+            if (!(loadFactor > 0)) { // Also rejects NaN
+                throw invalid_argument("The load factor of a hash table must be positive");
+            }
+            int count = 1;
+            shardBits = 0;
+            while (count < shardCount) {
+                count <<= 1;
+                shardBits++;
+            }
+            shards = vector<Shard>(count);
+            shardMask = count - 1;
+            maxLoadFactor = loadFactor;
+            for (Shard& shard : shards) {
+                shard.table.resize(bucketsPerShard < 1 ? 1 : bucketsPerShard);
+                shard.size = 0;
+            }
+        }
+
+        ConcurrentHashTable(const ConcurrentHashTable<K,V>&) = delete;
+        ConcurrentHashTable<K,V>& operator=(const ConcurrentHashTable<K,V>&) = delete;
+
+        // A method that returns the current number of nodes in the table (only a snapshot while other threads are writing)
+        int getSize() const {
+            int total = 0;
+            for (const Shard& shard : shards) {
+                shared_lock<shared_mutex> guard(shard.lock);
+                total += shard.size;
+            }
+            return total;
+        }
+
+        // A method that checks if the table is empty or not
+        bool isEmpty() const {
+            return getSize() == 0;
+        }
+
+        // A method that inserts a new node with a given key and value into the table, or updates the value if the key already exists
+        void insert(const K& key, const V& value) {
+            size_t h = hashFunction(key);
+            Shard& shard = shards[shardOf(h)];
+            unique_lock<shared_mutex> guard(shard.lock);
+            insertLocked(shard, h, key, value);
+        }
+
+        // A method that removes the node with a given key and returns whether it existed
+        bool remove(const K& key) {
+            size_t h = hashFunction(key);
+            Shard& shard = shards[shardOf(h)];
+            unique_lock<shared_mutex> guard(shard.lock);
+            auto& bucket = shard.table[bucketOf(h, shard.table.size())];
+            for (auto it = bucket.begin(); it != bucket.end(); it++) { // Loop through the nodes in the bucket using an iterator
+                if (it->key == key) {
+                    bucket.erase(it);
+                    shard.size--;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // A method that copies the value of a given key into value and returns whether the key exists
+        bool search(const K& key, V& value) const {
+            size_t h = hashFunction(key);
+            const Shard& shard = shards[shardOf(h)];
+            shared_lock<shared_mutex> guard(shard.lock); // Readers of the same shard proceed in parallel
+            return searchLocked(shard, h, key, value);
+        }
+
+        // A method that inserts a batch of key/value pairs, taking each shard's lock once
+        void insertBatch(const vector<pair<K,V>>& items) {
+            vector<size_t> hashes(items.size());
+            for (size_t i = 0; i < items.size(); i++) {
+                hashes[i] = hashFunction(items[i].first);
+            }
+            vector<vector<int>> groups = groupByShard(hashes);
+            for (size_t s = 0; s < groups.size(); s++) {
+                if (groups[s].empty()) {
+                    continue;
+                }
+                unique_lock<shared_mutex> guard(shards[s].lock);
+                for (int i : groups[s]) {
+                    insertLocked(shards[s], hashes[i], items[i].first, items[i].second);
+                }
+            }
+        }
+
+        // A method that looks up a batch of keys, taking each shard's lock once; found[i] tells whether values[i] was filled
+        void searchBatch(const vector<K>& keys, vector<V>& values, vector<bool>& found) const {
+            values.assign(keys.size(), V());
+            found.assign(keys.size(), false);
+            vector<size_t> hashes(keys.size());
+            for (size_t i = 0; i < keys.size(); i++) {
+                hashes[i] = hashFunction(keys[i]);
+            }
+            vector<vector<int>> groups = groupByShard(hashes);
+            for (size_t s = 0; s < groups.size(); s++) {
+                if (groups[s].empty()) {
+                    continue;
+                }
+                shared_lock<shared_mutex> guard(shards[s].lock);
+                for (int i : groups[s]) {
+                    found[i] = searchLocked(shards[s], hashes[i], keys[i], values[i]);
+                }
+            }
+        }
+
+        // A method that prints every shard's size and bucket count
+        void print() const {
+            for (size_t s = 0; s < shards.size(); s++) {
+                shared_lock<shared_mutex> guard(shards[s].lock);
+                cout << s << ": " << shards[s].size << " nodes in " << shards[s].table.size() << " buckets" << endl;
+            }
+        }
+
+        // A method that measures operations per second with a number of threads doing a mix of lookups and writes over keyRange keys.
+        // readPercent of the operations are searches; the rest alternate between inserts and removes. Keys must be constructible from an int.
+        static long long get_throughput(int threads, long long opsPerThread, int readPercent, int keyRange = 100000, int shardCount = 64) {
+            ConcurrentHashTable<K,V> table(shardCount);
+            for (int k = 0; k < keyRange; k += 2) { // Prefill half the key range so lookups hit about half the time
+                table.insert(K(k), V());
+            }
+            vector<thread> workers;
+            auto start = chrono::high_resolution_clock::now();
+            for (int t = 0; t < threads; t++) {
+                workers.push_back(thread([&table, t, opsPerThread, readPercent, keyRange]() {
+                    unsigned state = 2463534242u + (unsigned)t * 7919u; // A per-thread xorshift generator for keys and operations
+                    V value;
+                    for (long long i = 0; i < opsPerThread; i++) {
+                        state ^= state << 13;
+                        state ^= state >> 17;
+                        state ^= state << 5;
+                        K key = K((int)(state % (unsigned)keyRange));
+                        if ((int)((state >> 8) % 100) < readPercent) {
+                            table.search(key, value);
+                        }
+                        else if (i & 1) {
+                            table.insert(key, value);
+                        }
+                        else {
+                            table.remove(key);
+                        }
+                    }
+                }));
+            }
+            for (thread& worker : workers) {
+                worker.join();
+            }
+            auto stop = chrono::high_resolution_clock::now();
+            auto duration = chrono::duration_cast<chrono::microseconds>(stop - start);
+            long long ops = opsPerThread * threads;
+            return duration.count() == 0 ? ops * 1000000 : ops * 1000000 / duration.count();
+        }
+
+        // A method that runs the read-heavy (95% reads) and write-heavy (20% reads) modes and returns {read-heavy, write-heavy} operations per second
+        static vector<long long> get_benchmark(int threads, long long opsPerThread) {
+            return {get_throughput(threads, opsPerThread, 95), get_throughput(threads, opsPerThread, 20)};
+        }
+};
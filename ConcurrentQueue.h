@@ -0,0 +1,345 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+using namespace std;
+
+// The size of a cache line, used to keep indices written by different threads apart
+const size_t CACHE_LINE_SIZE = 64;
+
+// A helper function that rounds a capacity up to the next power of two, so indices can be masked instead of divided
+inline size_t round_up_to_power_of_two(size_t n) {
+    size_t result = 1;
+    while (result < n) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// A class template for bounded single-producer single-consumer queues using a ring buffer
+template <class T>
+class SpscQueue {
+    private:
+        vector<T> data; // The underlying vector to store the elements
+        size_t mask; // The capacity minus one, used to wrap indices with a bitwise and
+
+        alignas(CACHE_LINE_SIZE) atomic<size_t> head; // The next position to dequeue, written only by the consumer
+        size_t cachedTail; // The consumer's last seen copy of tail, refreshed only when the queue looks empty
+
+        alignas(CACHE_LINE_SIZE) atomic<size_t> tail; // The next position to enqueue, written only by the producer
+        size_t cachedHead; // The producer's last seen copy of head, refreshed only when the queue looks full
+
+        char padding[CACHE_LINE_SIZE - sizeof(size_t)]; // Keep the producer's fields off the next object's cache line
+
+    public:
+        // A constructor that creates a queue holding at least n elements (rounded up to a power of two)
+        SpscQueue(size_t n) : head(0), tail(0) {
+            size_t capacity = round_up_to_power_of_two(n < 2 ? 2 : n);
+            data.resize(capacity); // Allocate memory for the vector
+            mask = capacity - 1;
+            cachedTail = 0;
+            cachedHead = 0;
+        }
+
+        SpscQueue(const SpscQueue<T>&) = delete;
+        SpscQueue<T>& operator=(const SpscQueue<T>&) = delete;
+
+        // A method that returns the maximum number of elements the queue can hold
+        size_t getCapacity() const {
+            return mask + 1;
+        }
+
+        // A method that returns the current number of elements (only a snapshot while other threads are running)
+        size_t getSize() const {
+            return tail.load(memory_order_acquire) - head.load(memory_order_acquire);
+        }
+
+        // A method that adds an element at the rear of the queue, returning false if it is full (producer only)
+        bool tryEnqueue(const T& val) {
+            size_t t = tail.load(memory_order_relaxed);
+            if (t - cachedHead > mask) { // The queue looks full, so refresh the consumer's position
+                cachedHead = head.load(memory_order_acquire);
+                if (t - cachedHead > mask) { // Still full
+                    return false;
+                }
+            }
+            data[t & mask] = val; // Write the element before publishing it
+            tail.store(t + 1, memory_order_release);
+            return true;
+        }
+
+        // A method that removes an element from the front of the queue into val, returning false if it is empty (consumer only)
+        bool tryDequeue(T& val) {
+            size_t h = head.load(memory_order_relaxed);
+            if (h == cachedTail) { // The queue looks empty, so refresh the producer's position
+                cachedTail = tail.load(memory_order_acquire);
+                if (h == cachedTail) { // Still empty
+                    return false;
+                }
+            }
+            val = data[h & mask]; // Read the element before releasing its slot
+            head.store(h + 1, memory_order_release);
+            return true;
+        }
+
+        // A method that adds up to n elements with a single publish and returns how many fit (producer only)
+        size_t enqueueBatch(const T* items, size_t n) {
+            size_t t = tail.load(memory_order_relaxed);
+            size_t space = mask + 1 - (t - cachedHead); // Free slots according to the cached head
+            if (space < n) { // Not enough room in the cached view, so refresh it
+                cachedHead = head.load(memory_order_acquire);
+                space = mask + 1 - (t - cachedHead);
+            }
+            size_t count = n < space ? n : space;
+            for (size_t i = 0; i < count; i++) {
+                data[(t + i) & mask] = items[i];
+            }
+            tail.store(t + count, memory_order_release); // One release store publishes the whole batch
+            return count;
+        }
+
+        // A method that removes up to n elements with a single release and returns how many were taken (consumer only)
+        size_t dequeueBatch(T* out, size_t n) {
+            size_t h = head.load(memory_order_relaxed);
+            size_t available = cachedTail - h; // Filled slots according to the cached tail
+            if (available < n) { // Not enough elements in the cached view, so refresh it
+                cachedTail = tail.load(memory_order_acquire);
+                available = cachedTail - h;
+            }
+            size_t count = n < available ? n : available;
+            for (size_t i = 0; i < count; i++) {
+                out[i] = data[(h + i) & mask];
+            }
+            head.store(h + count, memory_order_release); // One release store frees the whole batch
+            return count;
+        }
+
+        // A method that measures how many elements per second one producer thread can pass to one consumer thread,
+        // throwing invalid_argument if the batch is empty
+        static long long get_throughput(long long items, size_t capacity = 1024, size_t batch = 1) {
+            if (batch == 0) {
+                throw invalid_argument("The throughput benchmark needs a batch of at least one element");
+            }
+            SpscQueue<T> queue(capacity);
+            vector<T> in(batch, T()); // The batch the producer sends
+            vector<T> out(batch); // The buffer the consumer receives into
+            auto start = chrono::high_resolution_clock::now();
+
+            thread producer([&]() {
+                long long sent = 0;
+                while (sent < items) {
+                    size_t want = (size_t)min<long long>((long long)batch, items - sent);
+                    size_t done = batch == 1 ? (size_t)queue.tryEnqueue(in[0]) : queue.enqueueBatch(in.data(), want);
+                    if (done == 0) {
+                        this_thread::yield(); // Let the consumer catch up
+                    }
+                    sent += (long long)done;
+                }
+            });
+            thread consumer([&]() {
+                long long received = 0;
+                while (received < items) {
+                    size_t done = batch == 1 ? (size_t)queue.tryDequeue(out[0]) : queue.dequeueBatch(out.data(), batch);
+                    if (done == 0) {
+                        this_thread::yield(); // Let the producer catch up
+                    }
+                    received += (long long)done;
+                }
+            });
+            producer.join();
+            consumer.join();
+
+            auto stop = chrono::high_resolution_clock::now();
+            auto duration = chrono::duration_cast<chrono::microseconds>(stop - start);
+            return duration.count() == 0 ? items * 1000000 : items * 1000000 / duration.count();
+        }
+};
+
+// A class template for bounded multi-producer multi-consumer queues using per-cell sequence numbers (Vyukov's design)
+template <class T>
+class MpmcQueue {
+    private:
+        // A cell of the ring: its sequence number says whether it is ready to be written or read for a given lap
+        struct Cell {
+            atomic<size_t> sequence;
+            T value;
+        };
+
+        vector<Cell> cells; // The ring of cells
+        size_t mask; // The capacity minus one, used to wrap positions with a bitwise and
+
+        alignas(CACHE_LINE_SIZE) atomic<size_t> enqueuePos; // The next position producers claim
+        alignas(CACHE_LINE_SIZE) atomic<size_t> dequeuePos; // The next position consumers claim
+        char padding[CACHE_LINE_SIZE - sizeof(size_t)]; // Keep the consumers' index off the next object's cache line
+
+    public:
+        // A constructor that creates a queue holding at least n elements (rounded up to a power of two)
+        MpmcQueue(size_t n) : cells(round_up_to_power_of_two(n < 2 ? 2 : n)), enqueuePos(0), dequeuePos(0) {
+            mask = cells.size() - 1;
+            for (size_t i = 0; i < cells.size(); i++) {
+                cells[i].sequence.store(i, memory_order_relaxed); // Cell i is free for the first lap at position i
+            }
+        }
+
+        MpmcQueue(const MpmcQueue<T>&) = delete;
+        MpmcQueue<T>& operator=(const MpmcQueue<T>&) = delete;
+
+        // A method that returns the maximum number of elements the queue can hold
+        size_t getCapacity() const {
+            return mask + 1;
+        }
+
+        // A method that adds an element at the rear of the queue, returning false if it is full
+        bool tryEnqueue(const T& val) {
+            size_t pos = enqueuePos.load(memory_order_relaxed);
+            while (true) {
+                Cell& cell = cells[pos & mask];
+                size_t seq = cell.sequence.load(memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                if (diff == 0) { // The cell is free for this lap, so try to claim the position
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                        cell.value = val;
+                        cell.sequence.store(pos + 1, memory_order_release); // Hand the cell to the consumer of this position
+                        return true;
+                    }
+                }
+                else if (diff < 0) { // The cell still holds an element from the previous lap
+                    return false;
+                }
+                else { // Another producer claimed the position first
+                    pos = enqueuePos.load(memory_order_relaxed);
+                }
+            }
+        }
+
+        // A method that removes an element from the front of the queue into val, returning false if it is empty
+        bool tryDequeue(T& val) {
+            size_t pos = dequeuePos.load(memory_order_relaxed);
+            while (true) {
+                Cell& cell = cells[pos & mask];
+                size_t seq = cell.sequence.load(memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+                if (diff == 0) { // The cell has been filled for this lap, so try to claim the position
+                    if (dequeuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                        val = cell.value;
+                        cell.sequence.store(pos + mask + 1, memory_order_release); // Free the cell for the next lap
+                        return true;
+                    }
+                }
+                else if (diff < 0) { // The cell has not been filled yet
+                    return false;
+                }
+                else { // Another consumer claimed the position first
+                    pos = dequeuePos.load(memory_order_relaxed);
+                }
+            }
+        }
+
+        // A method that claims a run of free cells with one compare-and-swap, fills them, and returns how many were added
+        size_t enqueueBatch(const T* items, size_t n) {
+            size_t pos = enqueuePos.load(memory_order_relaxed);
+            while (true) {
+                size_t count = 0; // The number of consecutive free cells starting at pos
+                while (count < n && count <= mask && cells[(pos + count) & mask].sequence.load(memory_order_acquire) == pos + count) {
+                    count++;
+                }
+                if (count == 0) { // Either full or another producer moved ahead
+                    size_t current = enqueuePos.load(memory_order_relaxed);
+                    if (current == pos) {
+                        return 0;
+                    }
+                    pos = current;
+                    continue;
+                }
+                if (enqueuePos.compare_exchange_weak(pos, pos + count, memory_order_relaxed)) { // Claim the whole run at once
+                    for (size_t i = 0; i < count; i++) {
+                        Cell& cell = cells[(pos + i) & mask];
+                        cell.value = items[i];
+                        cell.sequence.store(pos + i + 1, memory_order_release);
+                    }
+                    return count;
+                }
+            }
+        }
+
+        // A method that claims a run of filled cells with one compare-and-swap, drains them, and returns how many were taken
+        size_t dequeueBatch(T* out, size_t n) {
+            size_t pos = dequeuePos.load(memory_order_relaxed);
+            while (true) {
+                size_t count = 0; // The number of consecutive filled cells starting at pos
+                while (count < n && count <= mask && cells[(pos + count) & mask].sequence.load(memory_order_acquire) == pos + count + 1) {
+                    count++;
+                }
+                if (count == 0) { // Either empty or another consumer moved ahead
+                    size_t current = dequeuePos.load(memory_order_relaxed);
+                    if (current == pos) {
+                        return 0;
+                    }
+                    pos = current;
+                    continue;
+                }
+                if (dequeuePos.compare_exchange_weak(pos, pos + count, memory_order_relaxed)) { // Claim the whole run at once
+                    for (size_t i = 0; i < count; i++) {
+                        Cell& cell = cells[(pos + i) & mask];
+                        out[i] = cell.value;
+                        cell.sequence.store(pos + i + mask + 1, memory_order_release);
+                    }
+                    return count;
+                }
+            }
+        }
+
+        // A method that measures how many elements per second pass from a number of producer threads to a number of consumer threads,
+        // throwing invalid_argument unless there is at least one producer, one consumer and one element per batch
+        static long long get_throughput(int producers, int consumers, long long items, size_t capacity = 1024, size_t batch = 1) {
+            if (producers < 1 || consumers < 1 || batch == 0) {
+                throw invalid_argument("The throughput benchmark needs at least one producer, one consumer and one element per batch");
+            }
+            MpmcQueue<T> queue(capacity);
+            atomic<long long> received(0); // The number of elements taken by all consumers so far
+            vector<thread> threads;
+            auto start = chrono::high_resolution_clock::now();
+
+            for (int p = 0; p < producers; p++) {
+                long long share = items / producers + (p < items % producers ? 1 : 0); // Spread the items evenly over the producers
+                threads.push_back(thread([&queue, share, batch]() {
+                    vector<T> in(batch, T());
+                    long long sent = 0;
+                    while (sent < share) {
+                        size_t want = (size_t)min<long long>((long long)batch, share - sent);
+                        size_t done = batch == 1 ? (size_t)queue.tryEnqueue(in[0]) : queue.enqueueBatch(in.data(), want);
+                        if (done == 0) {
+                            this_thread::yield(); // Let the consumers catch up
+                        }
+                        sent += (long long)done;
+                    }
+                }));
+            }
+            for (int c = 0; c < consumers; c++) {
+                threads.push_back(thread([&queue, &received, items, batch]() {
+                    vector<T> out(batch);
+                    while (received.load(memory_order_relaxed) < items) {
+                        size_t done = batch == 1 ? (size_t)queue.tryDequeue(out[0]) : queue.dequeueBatch(out.data(), batch);
+                        if (done == 0) {
+                            this_thread::yield(); // Let the producers catch up
+                        }
+                        else {
+                            received.fetch_add((long long)done, memory_order_relaxed);
+                        }
+                    }
+                }));
+            }
+            for (thread& t : threads) {
+                t.join();
+            }
+
+            auto stop = chrono::high_resolution_clock::now();
+            auto duration = chrono::duration_cast<chrono::microseconds>(stop - start);
+            return duration.count() == 0 ? items * 1000000 : items * 1000000 / duration.count();
+        }
+};
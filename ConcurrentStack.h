@@ -0,0 +1,223 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <stdexcept>
+#include "HazardPointers.h"
+#include "Stack.h"
+using namespace std;
+
+// A class template for lock-free stacks (Treiber's algorithm) with hazard pointer reclamation and optional elimination backoff
+template <class T>
+class ConcurrentStack {
+    private:
+        // A class for stack nodes linked from the top down
+        struct Node {
+            T data; // The data stored in the node
+            Node* next; // The pointer to the node below
+
+            Node(const T& val) : data(val), next(nullptr) {}
+        };
+
+        static const int ELIMINATION_SLOTS = 16; // The number of slots where a push and a pop can meet
+        static const int ELIMINATION_SPINS = 64; // How long a parked push waits for a pop to take it
+
+        alignas(64) atomic<Node*> top; // The pointer to the top node of the stack
+        alignas(64) atomic<Node*> elimination[ELIMINATION_SLOTS]; // Nodes parked by pushes that lost a race on top
+        bool useElimination; // Whether failed pushes and pops try to meet in the elimination array
+
+        // A helper method that picks a pseudo-random elimination slot for the calling thread
+        static int pickSlot() {
+            thread_local unsigned state = (unsigned)hash<thread::id>()(this_thread::get_id()) | 1u;
+            state ^= state << 13; // xorshift keeps the pick cheap and spreads threads over the slots
+            state ^= state >> 17;
+            state ^= state << 5;
+            return (int)(state % ELIMINATION_SLOTS);
+        }
+
+        // A helper method that parks a node for a concurrent pop and returns true if one took it. The node stays published
+        // as a hazard while it is parked, so a pop that takes it can only retire it: its address cannot be reused by another
+        // push and parked in the same slot, which would let the withdraw below match a node that is not ours.
+        bool tryEliminatePush(Node* node) {
+            atomic<Node*>& slot = elimination[pickSlot()];
+            HazardPointers::protect(node);
+            Node* empty = nullptr;
+            if (!slot.compare_exchange_strong(empty, node)) { // The slot is busy, give up on eliminating
+                HazardPointers::clear();
+                return false;
+            }
+            bool taken = false;
+            for (int i = 0; i < ELIMINATION_SPINS && !taken; i++) { // Give a pop a short window to take the node
+                taken = slot.load(memory_order_acquire) != node;
+            }
+            if (!taken) {
+                Node* expected = node;
+                taken = !slot.compare_exchange_strong(expected, nullptr); // Withdraw the node, unless a pop got there first
+            }
+            HazardPointers::clear();
+            return taken;
+        }
+
+        // A helper method that takes a node parked by a concurrent push, or returns null
+        Node* tryEliminatePop() {
+            atomic<Node*>& slot = elimination[pickSlot()];
+            Node* node = slot.load(memory_order_acquire);
+            if (node != nullptr && slot.compare_exchange_strong(node, nullptr)) { // Winning the swap gives sole ownership of the node
+                return node;
+            }
+            return nullptr;
+        }
+
+    public:
+        // A constructor that creates an empty stack, with elimination backoff turned on or off
+        ConcurrentStack(bool elimination = true) : top(nullptr) {
+            useElimination = elimination;
+            for (int i = 0; i < ELIMINATION_SLOTS; i++) {
+                this->elimination[i].store(nullptr);
+            }
+        }
+
+        ConcurrentStack(const ConcurrentStack<T>&) = delete;
+        ConcurrentStack<T>& operator=(const ConcurrentStack<T>&) = delete;
+
+        // A destructor that frees the remaining nodes (no other thread may be using the stack)
+        ~ConcurrentStack() {
+            Node* node = top.load();
+            while (node != nullptr) {
+                Node* next = node->next;
+                delete node;
+                node = next;
+            }
+        }
+
+        // A method that checks if the stack is empty or not (only a snapshot while other threads are running)
+        bool isEmpty() const {
+            return top.load(memory_order_acquire) == nullptr;
+        }
+
+        // A method that adds a new element at the top of the stack
+        void push(const T& val) {
+            Node* node = new Node(val);
+            node->next = top.load(memory_order_relaxed);
+            while (!top.compare_exchange_weak(node->next, node, memory_order_release, memory_order_relaxed)) { // On failure next is reloaded with the new top
+                if (useElimination && tryEliminatePush(node)) { // Contended, so try to hand the node straight to a pop
+                    return;
+                }
+                node->next = top.load(memory_order_relaxed);
+            }
+        }
+
+        // A method that removes the top element into val, returning false if the stack is empty
+        bool pop(T& val) {
+            Node* node;
+            while (true) {
+                node = top.load(memory_order_acquire);
+                if (node == nullptr) { // Check if the stack is empty
+                    HazardPointers::clear();
+                    return false;
+                }
+                HazardPointers::protect(node); // Publish the node before reading its next pointer
+                if (top.load(memory_order_acquire) != node) { // The node may have been freed before it was published
+                    continue;
+                }
+                Node* next = node->next;
+                if (top.compare_exchange_strong(node, next, memory_order_acq_rel, memory_order_acquire)) {
+                    break;
+                }
+                if (useElimination) { // Contended, so try to take a node straight from a push
+                    Node* eliminated = tryEliminatePop();
+                    if (eliminated != nullptr) {
+                        HazardPointers::clear();
+                        val = eliminated->data;
+                        HazardPointers::retire(eliminated); // Its pusher may still be checking the slot for it
+                        return true;
+                    }
+                }
+            }
+            HazardPointers::clear();
+            val = node->data;
+            HazardPointers::retire(node); // Other threads may still be reading it, so defer the delete
+            return true;
+        }
+
+        // A method that copies the top element into val without removing it, returning false if the stack is empty
+        bool peek(T& val) const {
+            while (true) {
+                Node* node = top.load(memory_order_acquire);
+                if (node == nullptr) { // Check if the stack is empty
+                    HazardPointers::clear();
+                    return false;
+                }
+                HazardPointers::protect(node);
+                if (top.load(memory_order_acquire) == node) { // Still the top, so it cannot be freed while published
+                    val = node->data;
+                    HazardPointers::clear();
+                    return true;
+                }
+            }
+        }
+
+        // A static method that returns the most threads that may use lock-free stacks at once, leaving one hazard slot
+        // for the thread that starts them
+        static int maxThreads() {
+            return HazardPointers::MAX_THREADS - 1;
+        }
+
+        // A method that measures push/pop throughput from 1 thread up to maxThreads (all cores by default),
+        // returning one row of {threads, lock-free ops per second, mutex-wrapped Stack ops per second} per thread count.
+        // Throws invalid_argument before starting any thread if there are more threads than hazard slots.
+        static vector<vector<long long>> get_contention_benchmark(long long opsPerThread, int maxThreads = 0) {
+            if (maxThreads <= 0) {
+                maxThreads = max(1, (int)thread::hardware_concurrency());
+            }
+            if (maxThreads > ConcurrentStack<T>::maxThreads()) {
+                throw invalid_argument("The lock-free stack supports at most " + to_string(ConcurrentStack<T>::maxThreads()) + " threads");
+            }
+            vector<vector<long long>> rows;
+            for (int threads = 1; threads <= maxThreads; threads++) {
+                ConcurrentStack<T> lockFree;
+                long long lockFreeRate = run_benchmark(threads, opsPerThread, [&lockFree](const T& val) {
+                    lockFree.push(val);
+                    T out;
+                    lockFree.pop(out);
+                });
+
+                Stack<T> locked;
+                mutex lock;
+                long long lockedRate = run_benchmark(threads, opsPerThread, [&locked, &lock](const T& val) {
+                    lock_guard<mutex> guard(lock);
+                    locked.push(val);
+                    locked.pop();
+                });
+
+                rows.push_back({threads, lockFreeRate, lockedRate});
+            }
+            return rows;
+        }
+
+    private:
+        // A helper method that runs a push-then-pop operation on a number of threads and returns operations per second
+        template <class Operation>
+        static long long run_benchmark(int threads, long long opsPerThread, Operation operation) {
+            vector<thread> workers;
+            auto start = chrono::high_resolution_clock::now();
+            for (int t = 0; t < threads; t++) {
+                workers.push_back(thread([&operation, opsPerThread]() {
+                    T val = T();
+                    for (long long i = 0; i < opsPerThread; i++) {
+                        operation(val);
+                    }
+                }));
+            }
+            for (thread& worker : workers) {
+                worker.join();
+            }
+            auto stop = chrono::high_resolution_clock::now();
+            auto duration = chrono::duration_cast<chrono::microseconds>(stop - start);
+            long long ops = 2 * opsPerThread * threads; // Each iteration is one push and one pop
+            return duration.count() == 0 ? ops * 1000000 : ops * 1000000 / duration.count();
+        }
+};
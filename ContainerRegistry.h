@@ -0,0 +1,71 @@
+#pragma once
+#include <vector>
+#include <string>
+#include "ContainerTraits.h"
+#include "ToArray.h"
+#include "SortedArray.h"
+#include "Stack.h"
+#include "Queue.h"
+#include "LinkedList.h"
+#include "Hash Table.h"
+#include "BST.h"
+#include "Graph.h"
+#include "RequirementParser.h"
+using namespace std;
+
+// The containers the search engine can recommend, instantiated the way the benchmark runs them. Registering a new
+// container here (once its header specializes container_traits) makes it a candidate for every workload it can serve.
+using RegisteredContainers = ContainerRegistry<
+    ToArray<string>,
+    SortedArray<string>,
+    Stack<string>,
+    DynamicQueue<string>,
+    LinkedList<string>,
+    HashTable<int, string>,
+    BST<string>,
+    Graph<int>
+>;
+
+static_assert(RegisteredContainers::namesAreUnique(), "Two registered containers share a name");
+static_assert(RegisteredContainers::matching(GraphQueries | Elements) == 0, "No container serves both graph and element workloads");
+
+// A function that returns the names of the registered containers whose bits are set in a registry mask
+inline vector<string> registered_names(unsigned long long mask) {
+    vector<string> names;
+    for (size_t i = 0; i < RegisteredContainers::size; i++) {
+        if (mask & (1ull << i)) {
+            names.push_back(RegisteredContainers::entries[i].name);
+        }
+    }
+    return names;
+}
+
+// A function that returns the names of every registered container
+inline vector<string> all_data_structures() {
+    return registered_names(RegisteredContainers::matching(0));
+}
+
+// A function that keeps the registered containers that can serve a profile: those with every capability it requires,
+// those with constant-time inserts or deletes when it asks for them, and, under a memory budget, those whose estimated
+// footprint at the largest size fits in it
+inline vector<string> filter_candidates(const WorkloadProfile& profile) {
+    unsigned long long mask = RegisteredContainers::matching(required_capabilities(profile));
+    for (size_t i = 0; i < RegisteredContainers::size; i++) {
+        const ContainerInfo& info = RegisteredContainers::entries[i];
+        if ((profile.constantInsert && info.insertCost != Complexity::Constant)
+            || (profile.constantDelete && info.deleteCost != Complexity::Constant)) {
+            mask &= ~(1ull << i);
+        }
+        else if (profile.memoryBudget > 0 && info.bytesPerElement(sizeof(string)) * profile.maxSize > profile.memoryBudget) {
+            mask &= ~(1ull << i); // Every registered container holds string keys, whatever the profile's key type
+        }
+    }
+    return registered_names(mask);
+}
+
+// A function that returns a rough number of bytes a named container spends per element of a given size at full load,
+// or 0 for a name that is not registered
+inline double estimated_bytes_per_element(const string& ds, double elementBytes) {
+    int i = RegisteredContainers::indexOf(ds.c_str());
+    return i < 0 ? 0 : RegisteredContainers::entries[i].bytesPerElement(elementBytes);
+}
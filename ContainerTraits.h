@@ -0,0 +1,184 @@
+#pragma once
+#include <cstddef>
+#include <algorithm>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Compile-time descriptions of the containers the search engine can recommend. Each container header specializes
+// container_traits for its class template, declaring what the container can do as a bitmask of capabilities and how
+// its operations grow with the number of elements. A ContainerRegistry lists the containers on offer and matches a
+// mask of required capabilities against all of them in a constant expression, so a container becomes a candidate as
+// soon as it is registered, with no list of names to keep in step.
+
+// Where get_time_taken keeps the results of timed calls such as search(), so the compiler cannot drop a call whose
+// result is otherwise unused. Each thread has its own, so containers benchmarked on several threads do not share it.
+inline thread_local volatile long long benchmark_sink = 0;
+
+// A function template that times a workload's API on a container with its get_time_taken. Every get_time_taken expects
+// its insert() pass to have filled the container before it deletes or searches, so an API that does not start with
+// insert() gets the data inserted first, untimed.
+template <class Container>
+vector<int> time_workload(Container& container, const vector<string>& api, const vector<string>& data) {
+    if (api.empty() || api[0] != "insert()") {
+        container.get_time_taken(vector<string>{"insert()"}, data);
+    }
+    return container.get_time_taken(api, data);
+}
+
+// How a buffer-backed container sizes its storage: the capacity it starts with and the factor it grows by when full.
+// The defaults are the ones the containers have always used.
+struct GrowthPolicy {
+    int initialCapacity = 10; // The number of elements the buffer holds before it first grows
+    double growthFactor = 2; // How many times larger the buffer gets each time it fills up
+
+    // A method that returns the capacity a full buffer of a given capacity grows to, always at least one more element
+    int grow(int capacity) const {
+        return max(capacity + 1, (int)(capacity * growthFactor));
+    }
+};
+
+// One knob an auto-tuner may turn on a container, with the values worth trying
+struct TuningParameter {
+    string name; // What the knob is, such as "growth factor"
+    double baseline; // The value the container uses unless told otherwise
+    vector<double> values; // The values to try, the baseline among them
+};
+
+// A function that returns the tuning space of a GrowthPolicy for a benchmark over n data items: the initial capacity
+// (from the default up to the whole workload, so it never grows) and the growth factor
+inline vector<TuningParameter> growth_tuning_space(size_t n) {
+    GrowthPolicy defaults;
+    double items = (double)max((size_t)1, n);
+    return {
+        {"initial capacity", (double)defaults.initialCapacity, {(double)defaults.initialCapacity, max(1.0, items / 16), max(1.0, items / 4), items}},
+        {"growth factor", defaults.growthFactor, {defaults.growthFactor, 1.25, 1.5, 3, 4}}
+    };
+}
+
+// A function that builds a GrowthPolicy from a setting of the growth tuning space
+inline GrowthPolicy growth_policy(const vector<double>& setting) {
+    GrowthPolicy policy;
+    policy.initialCapacity = max(1, (int)setting[0]);
+    policy.growthFactor = setting[1];
+    return policy;
+}
+
+// The things a container can do for a workload, combined into a bitmask
+enum Capability : unsigned {
+    Elements = 1u << 0, // Stores individual keys that are inserted, deleted and searched
+    RandomAccess = 1u << 1, // Reads an element by position or key without a search
+    SortedOrder = 1u << 2, // Gives its elements back in key order
+    InsertionOrder = 1u << 3, // Gives its elements back in the order they were added
+    FifoOrder = 1u << 4, // Takes out the oldest element first
+    LifoOrder = 1u << 5, // Takes out the newest element first
+    Iteration = 1u << 6, // Walks over every element it holds
+    GraphQueries = 1u << 7 // Answers questions about vertices and edges, such as traversals and paths
+};
+
+// How the cost of an operation grows with the number of elements n
+enum class Complexity {
+    Constant, // O(1), possibly amortized
+    Logarithmic, // O(log n)
+    Linear, // O(n)
+    Linearithmic // O(n log n)
+};
+
+// A function that returns the big-O form of a complexity
+constexpr const char* complexity_name(Complexity cost) {
+    return cost == Complexity::Constant ? "O(1)"
+         : cost == Complexity::Logarithmic ? "O(log n)"
+         : cost == Complexity::Linear ? "O(n)"
+         : "O(n log n)";
+}
+
+// The traits of a container class, specialized next to each container. A specialization provides:
+//
+//     name                          the name the search engine reports and benchmarks the container under
+//     capabilities                  a bitmask of Capability values
+//     insertCost, deleteCost,       how insert(), delete() and search() grow with the number of elements
+//     searchCost
+//     bytesPerElement(elementBytes) a rough number of bytes spent per element of a given size at full load
+//     make(n)                       a new empty container for a benchmark over n data items
+//
+// A container with tuning knobs also provides:
+//
+//     tuningSpace(n)                the TuningParameters worth trying for a benchmark over n data items
+//     make(n, setting)              a new empty container with one value for each tuning parameter, in order
+template <class Container>
+struct container_traits;
+
+// The traits of one registered container, gathered into a value so a registry can hold them in an array
+struct ContainerInfo {
+    const char* name;
+    unsigned capabilities;
+    Complexity insertCost;
+    Complexity deleteCost;
+    Complexity searchCost;
+    double (*bytesPerElement)(double elementBytes);
+};
+
+// A function that gathers the traits of a container class into a ContainerInfo
+template <class Container>
+constexpr ContainerInfo container_info() {
+    using Traits = container_traits<Container>;
+    return {Traits::name, Traits::capabilities, Traits::insertCost, Traits::deleteCost, Traits::searchCost, &Traits::bytesPerElement};
+}
+
+// A type that carries a container class into a generic lambda, as in [](auto tag) { typename decltype(tag)::type c; }
+template <class Container>
+struct container_tag {
+    using type = Container;
+};
+
+// A compile-time list of the containers the search engine can recommend
+template <class... Containers>
+struct ContainerRegistry {
+    static constexpr size_t size = sizeof...(Containers);
+    static constexpr ContainerInfo entries[size] = {container_info<Containers>()...};
+
+    static_assert(size <= 64, "A registry mask has one bit per container");
+
+    // A method that returns a mask with bit i set for every registered container i that has all the required capabilities
+    static constexpr unsigned long long matching(unsigned required) {
+        unsigned long long mask = 0;
+        for (size_t i = 0; i < size; i++) {
+            if ((entries[i].capabilities & required) == required) {
+                mask |= 1ull << i;
+            }
+        }
+        return mask;
+    }
+
+    // A method that returns the index of the container with a given name, or -1 if none is registered under it
+    static constexpr int indexOf(const char* name) {
+        for (size_t i = 0; i < size; i++) {
+            const char* a = entries[i].name;
+            const char* b = name;
+            while (*a != '\0' && *a == *b) {
+                a++;
+                b++;
+            }
+            if (*a == *b) {
+                return (int)i;
+            }
+        }
+        return -1;
+    }
+
+    // A method that checks that no two containers are registered under the same name
+    static constexpr bool namesAreUnique() {
+        for (size_t i = 0; i < size; i++) {
+            if (indexOf(entries[i].name) != (int)i) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // A method that calls fn with a container_tag for every registered container, in registration order
+    template <class Function>
+    static void forEach(Function fn) {
+        (fn(container_tag<Containers>()), ...);
+    }
+};
@@ -0,0 +1,145 @@
+#pragma once
+#include <vector>
+#include <stdexcept>
+using namespace std;
+
+// A class template for an indexed d-ary min-heap over the items 0..capacity-1, each with a key of type K.
+// Every item remembers its position in the heap, so a shortest-path search can lower the key of a queued vertex in
+// place instead of pushing duplicates. A wider heap is shallower: pushes and decreases climb fewer levels, at the
+// cost of comparing more children on each pop, which pays off when decreases outnumber pops as they do in Dijkstra.
+template <class K>
+class DaryHeap {
+    private:
+        int arity; // The number of children of each heap node
+        vector<int> heap; // The items in heap order; the item with the smallest key is at index 0
+        vector<K> keys; // The key of each item, indexed by item
+        vector<int> position; // The index of each item in heap, or -1 if the item is not queued
+
+        // A helper method that places an item at a given heap index and records where it went
+        void place(int index, int item) {
+            heap[index] = item;
+            position[item] = index;
+        }
+
+        // A helper method that moves the item at a given heap index towards the root until its parent's key is no larger
+        void siftUp(int index) {
+            int item = heap[index];
+            while (index > 0) {
+                int parent = (index - 1) / arity;
+                if (!(keys[item] < keys[heap[parent]])) {
+                    break;
+                }
+                place(index, heap[parent]); // Pull the parent down instead of swapping, so each level costs one write
+                index = parent;
+            }
+            place(index, item);
+        }
+
+        // A helper method that moves the item at a given heap index towards the leaves until no child has a smaller key
+        void siftDown(int index) {
+            int item = heap[index];
+            int size = heap.size();
+            while (true) {
+                int first = index * arity + 1; // The first child of index
+                if (first >= size) {
+                    break;
+                }
+                int last = min(first + arity, size);
+                int smallest = first;
+                for (int c = first + 1; c < last; c++) { // Find the child with the smallest key
+                    if (keys[heap[c]] < keys[heap[smallest]]) {
+                        smallest = c;
+                    }
+                }
+                if (!(keys[heap[smallest]] < keys[item])) {
+                    break;
+                }
+                place(index, heap[smallest]);
+                index = smallest;
+            }
+            place(index, item);
+        }
+
+    public:
+        // A constructor that creates an empty heap for the items 0..capacity-1 with a given number of children per node
+        DaryHeap(int capacity, int d = 4) {
+            if (d < 2) {
+                throw invalid_argument("A d-ary heap needs at least two children per node");
+            }
+            arity = d;
+            keys.resize(capacity);
+            position.assign(capacity, -1);
+            heap.reserve(capacity);
+        }
+
+        // A method that checks if the heap is empty
+        bool isEmpty() const {
+            return heap.empty();
+        }
+
+        // A method that returns the number of queued items
+        int getSize() const {
+            return heap.size();
+        }
+
+        // A method that checks if a given item is queued
+        bool contains(int item) const {
+            return position[item] >= 0;
+        }
+
+        // A method that returns the key of a given item, which is only meaningful while it is queued or after it was popped
+        const K& getKey(int item) const {
+            return keys[item];
+        }
+
+        // A method that queues an item with a given key, or lowers its key if it is already queued; returns true if the heap
+        // changed, so a larger key for a queued item is ignored
+        bool push(int item, const K& key) {
+            if (position[item] < 0) { // A new item goes to the bottom and climbs
+                keys[item] = key;
+                heap.push_back(item);
+                siftUp(heap.size() - 1);
+                return true;
+            }
+            if (key < keys[item]) { // A decrease-key only ever moves the item towards the root
+                keys[item] = key;
+                siftUp(position[item]);
+                return true;
+            }
+            return false;
+        }
+
+        // A method that returns the item with the smallest key
+        int top() const {
+            if (heap.empty()) {
+                throw out_of_range("The heap is empty");
+            }
+            return heap[0];
+        }
+
+        // A method that returns the smallest key
+        const K& topKey() const {
+            return keys[top()];
+        }
+
+        // A method that removes and returns the item with the smallest key
+        int pop() {
+            int item = top();
+            position[item] = -1;
+            int last = heap.back();
+            heap.pop_back();
+            if (!heap.empty()) { // Move the last leaf to the root and let it sink
+                heap[0] = last;
+                siftDown(0);
+            }
+            return item;
+        }
+
+        // A method that removes every queued item, in time proportional to the number queued
+        void clear() {
+            for (int item : heap) {
+                position[item] = -1;
+            }
+            heap.clear();
+        }
+};
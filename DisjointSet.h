@@ -0,0 +1,64 @@
+#pragma once
+#include <vector>
+#include <utility>
+using namespace std;
+
+// A class for a disjoint-set forest (union-find) over the items 0..n-1. Union by size keeps the trees shallow and
+// find halves the path it walks, so any sequence of operations runs in nearly linear time and never recurses.
+class DisjointSet {
+    private:
+        vector<int> parent; // The parent of each item, or the item itself for the root of a set
+        vector<int> size; // The number of items in each set, only meaningful at its root
+        int count; // The number of disjoint sets
+
+    public:
+        // A constructor that puts each of n items in a set of its own
+        DisjointSet(int n) {
+            parent.resize(n);
+            size.assign(n, 1);
+            count = n;
+            for (int i = 0; i < n; i++) {
+                parent[i] = i;
+            }
+        }
+
+        // A method that returns the root of the set holding a given item, pointing every other node on the way at its grandparent
+        int find(int x) {
+            while (parent[x] != x) {
+                parent[x] = parent[parent[x]];
+                x = parent[x];
+            }
+            return x;
+        }
+
+        // A method that merges the sets holding two given items and returns true if they were separate
+        bool unite(int a, int b) {
+            a = find(a);
+            b = find(b);
+            if (a == b) {
+                return false;
+            }
+            if (size[a] < size[b]) { // Hang the smaller tree under the larger one
+                swap(a, b);
+            }
+            parent[b] = a;
+            size[a] += size[b];
+            count--;
+            return true;
+        }
+
+        // A method that checks if two given items are in the same set
+        bool connected(int a, int b) {
+            return find(a) == find(b);
+        }
+
+        // A method that returns the number of items in the set holding a given item
+        int setSize(int x) {
+            return size[find(x)];
+        }
+
+        // A method that returns the number of disjoint sets
+        int getCount() const {
+            return count;
+        }
+};
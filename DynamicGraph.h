@@ -0,0 +1,319 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <unordered_set>
+#include <chrono>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include "CSRGraph.h"
+#include "Graph.h"
+#include "GraphGenerator.h"
+using namespace std;
+
+// A class template for graphs that change continuously. Every edge is stored at most once, so inserting an existing
+// edge is a no-op, and edges can be removed or looked up without scanning a whole adjacency list. A vertex with few
+// neighbors keeps them in a sorted vector, which is compact and found by binary search; once its degree passes a
+// threshold the neighbors move to a hash set, so hubs answer in constant time. A set that shrinks to half the
+// threshold goes back to a vector, and the gap between the two sizes stops a vertex from flipping on every update.
+template <class T>
+class DynamicGraph {
+    private:
+        // The neighbors of one vertex: a sorted vector while small, a hash set once large
+        struct NeighborSet {
+            vector<T> sorted; // The neighbors in increasing order, used while hashed is false
+            unordered_set<T> hashed; // The neighbors of a high-degree vertex, used while hashed is true
+            bool isHashed = false;
+
+            size_t size() const {
+                return isHashed ? hashed.size() : sorted.size();
+            }
+        };
+
+        int numVertices; // The number of vertices in the graph
+        long long numEdges; // The number of distinct edges
+        bool directed; // Whether edges only go from u to v
+        size_t threshold; // The degree above which a vertex's neighbors move to a hash set
+        vector<NeighborSet> adjacency; // The neighbors of each vertex
+
+        // A helper method that adds v to the neighbors of u and returns false if it was already there
+        bool insertNeighbor(int u, T v) {
+            NeighborSet& set = adjacency[u];
+            if (set.isHashed) {
+                return set.hashed.insert(v).second;
+            }
+            auto it = lower_bound(set.sorted.begin(), set.sorted.end(), v);
+            if (it != set.sorted.end() && *it == v) {
+                return false;
+            }
+            set.sorted.insert(it, v);
+            if (set.sorted.size() > threshold) { // Too large to keep shifting elements, so switch to hashing
+                set.hashed.reserve(set.sorted.size() * 2);
+                set.hashed.insert(set.sorted.begin(), set.sorted.end());
+                vector<T>().swap(set.sorted);
+                set.isHashed = true;
+            }
+            return true;
+        }
+
+        // A helper method that removes v from the neighbors of u and returns false if it was not there
+        bool eraseNeighbor(int u, T v) {
+            NeighborSet& set = adjacency[u];
+            if (set.isHashed) {
+                if (set.hashed.erase(v) == 0) {
+                    return false;
+                }
+                if (set.hashed.size() <= threshold / 2) { // Small again, so go back to the compact sorted vector
+                    set.sorted.assign(set.hashed.begin(), set.hashed.end());
+                    std::sort(set.sorted.begin(), set.sorted.end());
+                    unordered_set<T>().swap(set.hashed);
+                    set.isHashed = false;
+                }
+                return true;
+            }
+            auto it = lower_bound(set.sorted.begin(), set.sorted.end(), v);
+            if (it == set.sorted.end() || *it != v) {
+                return false;
+            }
+            set.sorted.erase(it);
+            return true;
+        }
+
+    public:
+        // A constructor that creates a graph with a given number of vertices and no edges, undirected unless told otherwise,
+        // whose vertices switch to hash sets above a given degree
+        DynamicGraph(int n, bool isDirected = false, size_t hashThreshold = 64) {
+            numVertices = n;
+            numEdges = 0;
+            directed = isDirected;
+            threshold = max((size_t)2, hashThreshold);
+            adjacency.resize(n);
+        }
+
+        // A method that adds an edge from u to v (and from v to u if undirected) and returns false if it already existed
+        bool addEdge(T u, T v) {
+            if (!insertNeighbor(u, v)) {
+                return false;
+            }
+            if (!directed && u != v) {
+                insertNeighbor(v, u);
+            }
+            numEdges++;
+            return true;
+        }
+
+        // A method that removes the edge from u to v (and from v to u if undirected) and returns false if there was none
+        bool removeEdge(T u, T v) {
+            if (!eraseNeighbor(u, v)) {
+                return false;
+            }
+            if (!directed && u != v) {
+                eraseNeighbor(v, u);
+            }
+            numEdges--;
+            return true;
+        }
+
+        // A method that checks if there is an edge from u to v, by binary search on a small vertex or hashing on a large one
+        bool hasEdge(T u, T v) const {
+            const NeighborSet& set = adjacency[u];
+            if (set.isHashed) {
+                return set.hashed.count(v) != 0;
+            }
+            return binary_search(set.sorted.begin(), set.sorted.end(), v);
+        }
+
+        // A method that returns the number of neighbors of a given vertex
+        int degree(int v) const {
+            return (int)adjacency[v].size();
+        }
+
+        // A method that returns the number of vertices in the graph
+        int getNumVertices() const {
+            return numVertices;
+        }
+
+        // A method that returns the number of distinct edges in the graph
+        long long getNumEdges() const {
+            return numEdges;
+        }
+
+        // A method that checks if edges only go one way
+        bool isDirected() const {
+            return directed;
+        }
+
+        // A method that checks if a given vertex currently keeps its neighbors in a hash set
+        bool isHashed(int v) const {
+            return adjacency[v].isHashed;
+        }
+
+        // A method that calls fn on every neighbor of a given vertex, in increasing order for a small vertex and in no
+        // particular order for a hashed one
+        template <class Function>
+        void forEachNeighbor(int v, Function fn) const {
+            const NeighborSet& set = adjacency[v];
+            if (set.isHashed) {
+                for (T w : set.hashed) {
+                    fn(w);
+                }
+            }
+            else {
+                for (T w : set.sorted) {
+                    fn(w);
+                }
+            }
+        }
+
+        // A method that returns the neighbors of a given vertex in increasing order
+        vector<T> neighbors(int v) const {
+            vector<T> result;
+            result.reserve(degree(v));
+            forEachNeighbor(v, [&result](T w) { result.push_back(w); });
+            if (adjacency[v].isHashed) {
+                std::sort(result.begin(), result.end());
+            }
+            return result;
+        }
+
+        // A method that freezes the current edges into a compressed sparse row graph with every neighbor list sorted
+        CSRGraph<T> freeze() const {
+            vector<vector<T>> lists(numVertices);
+            for (int v = 0; v < numVertices; v++) {
+                lists[v] = neighbors(v);
+            }
+            return CSRGraph<T>(lists, directed);
+        }
+
+        // A method that returns the approximate bytes used by the neighbor sets, counting a hash set's buckets and nodes
+        size_t memoryBytes() const {
+            size_t bytes = adjacency.capacity() * sizeof(NeighborSet);
+            for (const NeighborSet& set : adjacency) {
+                if (set.isHashed) {
+                    bytes += set.hashed.bucket_count() * sizeof(void*) + set.hashed.size() * (sizeof(T) + 2 * sizeof(void*));
+                }
+                else {
+                    bytes += set.sorted.capacity() * sizeof(T);
+                }
+            }
+            return bytes;
+        }
+
+        // A method that prints all vertices and their neighbors in the graph
+        void print() const {
+            for (int i = 0; i < numVertices; i++) { // Loop through all vertices in the graph
+                cout << i << ": "; // Print the current vertex
+                for (T j : neighbors(i)) { // Loop through the neighbors of the current vertex in order
+                    cout << j << " "; // Print each adjacent vertex
+                }
+                cout << endl;
+            }
+        }
+
+        // A static method that measures a churning workload on a generated graph of n vertices: after the initial edges are in,
+        // it runs a number of interleaved operations (40% inserts of random edges, 40% removals of live edges, 20% edge lookups),
+        // first on a Graph that checks for a duplicate before every insert, as callers must today, and then on a DynamicGraph.
+        // Returns {Graph microseconds, DynamicGraph microseconds}.
+        static vector<int> get_churn_time_taken(const string& model, int n, long long operations, unsigned seed = 1) {
+            if (n <= 0) { // There are no vertices to join
+                return {0, 0};
+            }
+            vector<pair<int,int>> edges = generate_edges(model, n, 8, seed);
+
+            // Script the operations up front against a reference set, so both graphs see the same sequence and every
+            // removal names an edge that is live at that point
+            enum Kind { Insert, Remove, Lookup };
+            vector<pair<Kind, pair<int,int>>> script;
+            script.reserve(operations);
+            set<pair<int,int>> live; // Each undirected edge as (smaller, larger)
+            vector<pair<int,int>> liveList; // The same edges, for picking a random one to remove
+            auto key = [](int u, int v) { return make_pair(min(u, v), max(u, v)); };
+            for (const pair<int,int>& e : edges) {
+                if (live.insert(key(e.first, e.second)).second) {
+                    liveList.push_back(e);
+                }
+            }
+            mt19937 rng(seed + 1);
+            uniform_int_distribution<int> vertex(0, n - 1);
+            uniform_int_distribution<int> percent(0, 99);
+            for (long long i = 0; i < operations; i++) {
+                int roll = percent(rng);
+                if (roll < 40 || liveList.empty()) {
+                    pair<int,int> e; // Reuse the model's endpoints so hubs keep their skew, if the model gave any edges
+                    e.first = edges.empty() ? vertex(rng) : edges[rng() % edges.size()].first;
+                    e.second = vertex(rng);
+                    script.push_back(make_pair(Insert, e));
+                    if (live.insert(key(e.first, e.second)).second) {
+                        liveList.push_back(e);
+                    }
+                }
+                else if (roll < 80) {
+                    size_t pick = rng() % liveList.size();
+                    pair<int,int> e = liveList[pick];
+                    liveList[pick] = liveList.back(); // Swap-remove keeps the pick constant time
+                    liveList.pop_back();
+                    live.erase(key(e.first, e.second));
+                    script.push_back(make_pair(Remove, e));
+                }
+                else {
+                    script.push_back(make_pair(Lookup, make_pair(vertex(rng), vertex(rng))));
+                }
+            }
+
+            vector<int> time_for_churn;
+
+            Graph<T> graph(n);
+            for (const pair<int,int>& e : edges) {
+                if (!graph.hasEdge(e.first, e.second)) {
+                    graph.addEdge(e.first, e.second);
+                }
+            }
+            auto start = chrono::high_resolution_clock::now();
+            long long found = 0;
+            for (const auto& op : script) {
+                int u = op.second.first;
+                int v = op.second.second;
+                if (op.first == Insert) {
+                    if (!graph.hasEdge(u, v)) {
+                        graph.addEdge(u, v);
+                    }
+                }
+                else if (op.first == Remove) {
+                    graph.removeEdge(u, v);
+                }
+                else {
+                    found += graph.hasEdge(u, v);
+                }
+            }
+            benchmark_sink = found;
+            auto stop = chrono::high_resolution_clock::now();
+            time_for_churn.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+            DynamicGraph<T> dynamic(n);
+            for (const pair<int,int>& e : edges) {
+                dynamic.addEdge(e.first, e.second);
+            }
+            start = chrono::high_resolution_clock::now();
+            found = 0;
+            for (const auto& op : script) {
+                int u = op.second.first;
+                int v = op.second.second;
+                if (op.first == Insert) {
+                    dynamic.addEdge(u, v);
+                }
+                else if (op.first == Remove) {
+                    dynamic.removeEdge(u, v);
+                }
+                else {
+                    found += dynamic.hasEdge(u, v);
+                }
+            }
+            benchmark_sink = found;
+            stop = chrono::high_resolution_clock::now();
+            time_for_churn.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+            return time_for_churn;
+        }
+};
@@ -1,56 +1,247 @@
+#pragma once
 #include <iostream>
 #include <vector>
 #include <queue>
 #include <stack>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <atomic>
+#include <stdexcept>
+#include "CSRGraph.h"
+#include "DaryHeap.h"
+#include "DisjointSet.h"
+#include "GraphGenerator.h"
+#include "VisitMarks.h"
+#include "ContainerTraits.h"
 using namespace std;
 
+// A struct for the result of a single-source shortest-path search: the distance to every vertex (infinity if unreachable)
+// and the vertex before it on a shortest path (-1 for the source and unreachable vertices)
+struct ShortestPaths {
+    vector<double> distance;
+    vector<int> parent;
+};
+
+// A struct for the result of a point-to-point query: the path length (infinity if there is no path) and its vertices in order
+struct Route {
+    double distance;
+    vector<int> path;
+};
+
 // A class template for graphs using adjacency lists
 template <class T>
 class Graph {
     private:
         int numVertices; // The number of vertices in the graph
         vector<vector<T>> adjList; // The vector of vectors to store the adjacency lists of each vertex
+        vector<vector<double>> weightList; // The weight of each edge, at the same index as its neighbor in adjList
+        bool directed; // Whether edges only go from u to v
+
+        vector<vector<T>> inList; // The incoming neighbors of each vertex of a directed graph, built for backward searches
+        vector<vector<double>> inWeightList; // The weights of the incoming edges, at the same index as in inList
+        bool inListsValid; // Whether inList matches the current edges
+
+        VisitMarks marks; // The visited flags, reused by every traversal through generation stamps
+        vector<pair<int, size_t>> dfsStack; // The explicit depth-first stack of (vertex, next neighbor index), reused across calls
+        vector<int> bfsQueue; // The breadth-first queue, reused across calls
+        long long numEdges; // The number of edges added and not yet removed
+
+        // A helper method that runs the iterative depth-first traversal from v within the current marks generation, calling
+        // visit when a vertex is discovered and finish when all of its neighbors are done; returns false if the visitor stopped it
+        template <class Visitor, class Finish>
+        bool explore(int v, Visitor& visit, Finish finish) {
+            dfsStack.clear();
+            marks.visit(v);
+            if (!call_visitor(visit, v)) {
+                return false;
+            }
+            dfsStack.push_back(make_pair(v, (size_t)0));
+            while (!dfsStack.empty()) { // Loop until every branch has been explored
+                int u = dfsStack.back().first;
+                size_t& next = dfsStack.back().second; // The next neighbor of u to look at
+                if (next < adjList[u].size()) {
+                    T w = adjList[u][next++];
+                    if (marks.visit(w)) { // Descend into the first unvisited neighbor, as the recursive version would
+                        if (!call_visitor(visit, w)) {
+                            return false;
+                        }
+                        dfsStack.push_back(make_pair((int)w, (size_t)0));
+                    }
+                }
+                else { // Every neighbor of u is done, so backtrack
+                    finish(u);
+                    dfsStack.pop_back();
+                }
+            }
+            return true;
+        }
 
-        // A helper method that performs a depth-first traversal from a given vertex, marking the visited vertices in a vector
-        void dfsHelper(int v, vector<bool>& visited) {
-            visited[v] = true; // Mark the current vertex as visited
-            cout << v << " "; // Print the current vertex
-            for (T u : adjList[v]) { // Loop through the adjacent vertices of the current vertex
-                if (!visited[u]) { // Check if the adjacent vertex is not visited
-                    dfsHelper(u, visited); // Recursively traverse from the adjacent vertex
+        // A helper method that rebuilds the incoming lists of a directed graph if edges changed since they were last built
+        void buildInLists() {
+            if (inListsValid) {
+                return;
+            }
+            inList.assign(numVertices, vector<T>());
+            inWeightList.assign(numVertices, vector<double>());
+            for (int u = 0; u < numVertices; u++) {
+                for (size_t i = 0; i < adjList[u].size(); i++) {
+                    inList[adjList[u][i]].push_back(u);
+                    inWeightList[adjList[u][i]].push_back(weightList[u][i]);
                 }
             }
+            inListsValid = true;
         }
 
-        // A helper method that performs a breadth-first traversal from a given vertex, marking the visited vertices in a vector
-        void bfsHelper(int v, vector<bool>& visited) {
-            queue<int> q; // Create an empty queue to store the vertices to be visited
-            q.push(v); // Enqueue the current vertex
-            visited[v] = true; // Mark the current vertex as visited
-            while (!q.empty()) { // Loop until the queue is empty
-                int u = q.front(); // Dequeue a vertex from the queue and store it in a variable
-                q.pop();
-                cout << u << " "; // Print the dequeued vertex
-                for (T w : adjList[u]) { // Loop through the adjacent vertices of the dequeued vertex
-                    if (!visited[w]) { // Check if the adjacent vertex is not visited
-                        q.push(w); // Enqueue the adjacent vertex
-                        visited[w] = true; // Mark the adjacent vertex as visited
-                    }
+        // A helper method that renumbers per-vertex labels as 0, 1, 2, ... in the order each label first appears by vertex id
+        static int compactLabels(vector<int>& labels) {
+            vector<int> id(labels.size(), -1); // The new number of each old label, which is always a vertex id
+            int count = 0;
+            for (int& label : labels) {
+                if (id[label] < 0) {
+                    id[label] = count++;
                 }
+                label = id[label];
             }
+            return count;
+        }
+
+        // A helper method that turns a sequence of vertices into a permutation that numbers them in that order
+        static vector<int> sequenceToPermutation(const vector<int>& sequence) {
+            vector<int> perm(sequence.size());
+            for (size_t i = 0; i < sequence.size(); i++) {
+                perm[sequence[i]] = (int)i;
+            }
+            return perm;
+        }
+
+        // A helper method that removes the last occurrence of a neighbor from one adjacency list and its weight; returns false if absent
+        bool removeFromList(int u, T v) {
+            auto it = find(adjList[u].rbegin(), adjList[u].rend(), v);
+            if (it == adjList[u].rend()) {
+                return false;
+            }
+            size_t index = adjList[u].rend() - it - 1;
+            adjList[u].erase(adjList[u].begin() + index);
+            weightList[u].erase(weightList[u].begin() + index);
+            return true;
         }
 
     public:
-        // A constructor that creates a graph with a given number of vertices and no edges
-        Graph(int n) {
+        // A constructor that creates a graph with a given number of vertices and no edges, undirected unless told otherwise
+        Graph(int n, bool isDirected = false) {
             numVertices = n;
+            numEdges = 0;
+            directed = isDirected;
+            inListsValid = false;
             adjList.resize(n); // Resize the vector of vectors to have n vectors, one for each vertex
+            weightList.resize(n);
         }
 
-        // A method that adds an edge between two given vertices in the graph, assuming it is undirected and unweighted
+        // A static method that builds a graph from an edge list, with optional weights at the same indexes (weight 1 if empty).
+        // A first pass counts every vertex's degree so each list is allocated once at its final size, with no regrowth per edge.
+        // Throws out_of_range if an edge names a vertex outside 0 .. n - 1, and invalid_argument if the weights do not match the edges.
+        static Graph<T> fromEdgeList(int n, const vector<pair<T,T>>& edges, bool directed = false, const vector<double>& weights = vector<double>()) {
+            if (!weights.empty() && weights.size() != edges.size()) {
+                throw invalid_argument("An edge list needs one weight per edge, or none");
+            }
+            check_edge_list(n, edges);
+            Graph<T> g(n, directed);
+            vector<int> degree(n, 0);
+            for (const pair<T,T>& e : edges) {
+                degree[e.first]++;
+                if (!directed) {
+                    degree[e.second]++;
+                }
+            }
+            for (int v = 0; v < n; v++) {
+                g.adjList[v].reserve(degree[v]);
+                g.weightList[v].reserve(degree[v]);
+            }
+            for (size_t e = 0; e < edges.size(); e++) {
+                g.addEdge(edges[e].first, edges[e].second, weights.empty() ? 1.0 : weights[e]);
+            }
+            return g;
+        }
+
+        // A method that adds an edge of weight 1 between two given vertices in the graph
         void addEdge(T u, T v) {
+            addEdge(u, v, 1.0);
+        }
+
+        // A method that adds an edge with a given non-negative weight from u to v, and from v to u if the graph is undirected
+        void addEdge(T u, T v, double w) {
+            if (!(w >= 0)) { // Also rejects NaN; the shortest-path searches rely on weights never being negative
+                throw invalid_argument("Edge weights must be non-negative");
+            }
             adjList[u].push_back(v); // Add v to the adjacency list of u
-            adjList[v].push_back(u); // Add u to the adjacency list of v
+            weightList[u].push_back(w);
+            if (!directed) {
+                adjList[v].push_back(u); // Add u to the adjacency list of v
+                weightList[v].push_back(w);
+            }
+            numEdges++;
+            inListsValid = false;
+        }
+
+        // A method that removes one edge between two given vertices and returns true if it existed. Each list is searched
+        // from the back, so removing edges in the reverse of the order they were added takes constant time per edge
+        bool removeEdge(T u, T v) {
+            if (!removeFromList(u, v)) {
+                return false; // There is no such edge
+            }
+            if (!directed) {
+                removeFromList(v, u); // A self-loop is stored twice in one list, so this removes the other copy
+            }
+            numEdges--;
+            inListsValid = false;
+            return true;
+        }
+
+        // A method that checks if edges only go one way
+        bool isDirected() const {
+            return directed;
+        }
+
+        // A method that returns the number of vertices in the graph
+        int getNumVertices() const {
+            return numVertices;
+        }
+
+        // A method that returns the number of edges in the graph
+        long long getNumEdges() const {
+            return numEdges;
+        }
+
+        // A method that checks if there is an edge from u to v by scanning the adjacency list of u
+        bool hasEdge(T u, T v) const {
+            return find(adjList[u].begin(), adjList[u].end(), v) != adjList[u].end();
+        }
+
+        // A method that returns the adjacency list of a given vertex
+        const vector<T>& neighbors(int v) const {
+            return adjList[v];
+        }
+
+        // A method that returns the weights of the edges leaving a given vertex, in the same order as its neighbors
+        const vector<double>& weights(int v) const {
+            return weightList[v];
+        }
+
+        // A method that freezes the adjacency lists into a compressed sparse row graph with the same neighbor order
+        CSRGraph<T> freeze() const {
+            return CSRGraph<T>(adjList, directed);
+        }
+
+        // A method that returns the bytes used by the adjacency and weight lists, counting each list's header and reserved capacity
+        size_t memoryBytes() const {
+            size_t bytes = adjList.capacity() * sizeof(vector<T>) + weightList.capacity() * sizeof(vector<double>);
+            for (int v = 0; v < numVertices; v++) {
+                bytes += adjList[v].capacity() * sizeof(T) + weightList[v].capacity() * sizeof(double);
+            }
+            return bytes;
         }
 
         // A method that prints all vertices and their adjacency lists in the graph
@@ -64,80 +255,968 @@ class Graph {
             }
         }
 
-        // A method that performs a depth-first traversal from a given vertex in the graph and prints all visited vertices 
+        // A method that performs an iterative depth-first traversal from a given vertex, calling visit on each vertex in the
+        // same order as a recursive traversal would; a visitor that returns false stops the traversal early
+        template <class Visitor>
+        void dfs(int v, Visitor visit) {
+            marks.begin(numVertices); // Start a new generation instead of allocating fresh visited flags
+            explore(v, visit, [](int) {});
+        }
+
+        // A method that performs a breadth-first traversal from a given vertex, calling visit on each vertex in the order it is
+        // dequeued; a visitor that returns false stops the traversal early
+        template <class Visitor>
+        void bfs(int v, Visitor visit) {
+            marks.begin(numVertices); // Start a new generation instead of allocating fresh visited flags
+            bfsQueue.clear();
+            bfsQueue.push_back(v);
+            marks.visit(v);
+            for (size_t head = 0; head < bfsQueue.size(); head++) { // The vector doubles as the queue, read from head onwards
+                int u = bfsQueue[head];
+                if (!call_visitor(visit, u)) {
+                    return;
+                }
+                for (T w : adjList[u]) { // Loop through the adjacent vertices of the dequeued vertex
+                    if (marks.visit(w)) { // Enqueue each adjacent vertex the first time it is seen
+                        bfsQueue.push_back(w);
+                    }
+                }
+            }
+        }
+
+        // A method that returns the vertices in depth-first order from a given vertex
+        vector<int> dfsOrder(int v) {
+            vector<int> order;
+            dfs(v, [&order](int u) { order.push_back(u); });
+            return order;
+        }
+
+        // A method that returns the vertices in breadth-first order from a given vertex
+        vector<int> bfsOrder(int v) {
+            vector<int> order;
+            bfs(v, [&order](int u) { order.push_back(u); });
+            return order;
+        }
+
+        // A method that performs a depth-first traversal from a given vertex in the graph and prints all visited vertices
         void dfs(int v) {
-            vector<bool> visited(numVertices, false); // Create a vector of booleans to store whether each vertex is visited or not, initialized to false 
-            dfsHelper(v, visited); // Call the helper method to traverse from the given vertex 
+            dfs(v, [](int u) { cout << u << " "; }); // Print each vertex as it is visited
             cout << endl;
         }
 
-        // A method that performs a breadth-first traversal from a given vertex in the graph and prints all visited vertices 
+        // A method that performs a breadth-first traversal from a given vertex in the graph and prints all visited vertices
         void bfs(int v) {
-            vector<bool> visited(numVertices, false); // Create a vector of booleans to store whether each vertex is visited or not, initialized to false 
-            bfsHelper(v, visited); // Call the helper method to traverse from the given vertex 
+            bfs(v, [](int u) { cout << u << " "; }); // Print each vertex as it is dequeued
             cout << endl;
         }
 
-        // A method to sort the values in the graph
-        void sort() {
-            reset(); // Reset the visited flag of all nodes
-            std::vector<T> sorted; // Create a vector to store the sorted values
-            for (GraphNode<T>* node : nodes) { // Loop through the nodes in the graph
-                if (!node->visited) { // If the node has not been visited
-                    sort(node, sorted); // Call the helper method on the node and the vector
+        // A method that returns every vertex in depth-first postorder, starting a new traversal at each unvisited vertex so all
+        // components are covered; for a graph without cycles the reverse of this order is a topological order
+        vector<int> sort() {
+            vector<int> sorted; // The vertices in the order their traversals finish
+            sorted.reserve(numVertices);
+            marks.begin(numVertices);
+            auto keepGoing = [](int) {};
+            for (int v = 0; v < numVertices; v++) { // Loop through the vertices in the graph
+                if (!marks.isVisited(v)) {
+                    explore(v, keepGoing, [&sorted](int u) { sorted.push_back(u); });
                 }
             }
-            for (int i = 0; i < nodes.size(); i++) { // Loop through the nodes in the graph
-                nodes[i]->data = sorted[i]; // Assign the sorted values to the nodes
+            return sorted;
+        }
+
+        // A method that searches depth-first from a source vertex for a given vertex and returns true if it can be reached;
+        // the traversal stops as soon as the vertex is visited, and a vertex outside the graph is never found
+        bool search(int source, T value) {
+            if (source < 0 || source >= numVertices || value < 0 || value >= numVertices) {
+                return false;
+            }
+            bool found = false;
+            dfs(source, [value, &found](int u) {
+                found = (u == value);
+                return !found;
+            });
+            return found;
+        }
+
+        // A method that checks if v can be reached from u, which for an undirected graph means they are in the same component;
+        // the breadth-first search stops once v is reached
+        bool connected(int u, int v) {
+            bool found = false;
+            bfs(u, [v, &found](int w) {
+                found = (w == v);
+                return !found;
+            });
+            return found;
+        }
+
+        // A method to reverse the order of the edges in the graph
+        void reverse() {
+            for (int v = 0; v < numVertices; v++) { // Loop through the adjacency lists in the graph
+                std::reverse(adjList[v].begin(), adjList[v].end()); // Reverse the order of the neighbors vector
+                std::reverse(weightList[v].begin(), weightList[v].end()); // Keep each weight at its neighbor's index
             }
         }
 
-        // A helper method to sort the values in the subtree rooted at a given node using depth-first search
-        void sort(GraphNode<T>* node, std::vector<T>& sorted) {
-            node->visited = true; // Mark the node as visited
-            for (GraphNode<T>* neighbor : node->neighbors) { // Loop through the neighbors of the node
-                if (!neighbor->visited) { // If the neighbor has not been visited
-                    sort(neighbor, sorted); // Recursively sort the neighbor and its subtree
+        // A method that finds the shortest distances from a given vertex with Dijkstra's algorithm on an indexed d-ary heap.
+        // Each vertex is queued at most once and lowered in place, so the heap never holds more than numVertices entries.
+        ShortestPaths dijkstra(int source, int arity = 4) const {
+            ShortestPaths result;
+            result.distance.assign(numVertices, INFINITY);
+            result.parent.assign(numVertices, -1);
+            DaryHeap<double> heap(numVertices, arity);
+            result.distance[source] = 0;
+            heap.push(source, 0);
+            while (!heap.isEmpty()) { // Settle the closest queued vertex each round
+                int u = heap.pop();
+                double du = result.distance[u];
+                for (size_t i = 0; i < adjList[u].size(); i++) { // Relax every edge leaving u
+                    int v = adjList[u][i];
+                    double nd = du + weightList[u][i];
+                    if (nd < result.distance[v]) {
+                        result.distance[v] = nd;
+                        result.parent[v] = u;
+                        heap.push(v, nd);
+                    }
                 }
             }
-            sorted.push_back(node->data); // Add the node's data to the vector
+            return result;
         }
 
-        // A method to search for a value in the graph
-        bool search(T value) const {
-            reset(); // Reset the visited flag of all nodes
-            for (GraphNode<T>* node : nodes) { // Loop through the nodes in the graph
-                if (!node->visited) { // If the node has not been visited
-                    if (search(node, value)) { // Call the helper method on the node and the value
-                        return true; // If the value is found, return true
+        // A method that finds the shortest distances from a given vertex with parallel delta-stepping (Meyer and Sanders).
+        // Vertices sit in buckets of width delta; a bucket's light edges (weight <= delta) are relaxed repeatedly until the bucket
+        // stays empty, then its heavy edges once. Within a step every thread relaxes a slice of the bucket into requests addressed
+        // to the owner of each target (vertex % threads), and the owners then apply their requests, so no two threads ever write
+        // the same vertex and no locks are needed. A delta of 0 picks the average edge weight.
+        ShortestPaths deltaStepping(int source, double delta = 0, int threads = 0) const {
+            if (threads <= 0) {
+                threads = max(1, (int)thread::hardware_concurrency());
+            }
+            const int n = numVertices;
+            const size_t serialWork = 1 << 10; // Below this many frontier vertices a step runs on the calling thread only
+            if (delta <= 0) {
+                double total = 0;
+                long long count = 0;
+                for (const vector<double>& list : weightList) {
+                    for (double w : list) {
+                        total += w;
+                        count++;
+                    }
+                }
+                delta = (count > 0 && total > 0) ? total / count : 1.0;
+            }
+
+            struct Request {
+                int vertex; // The vertex whose distance may drop
+                int from; // The vertex the edge leaves
+                double distance; // The distance through that edge
+            };
+            ShortestPaths result;
+            result.distance.assign(n, INFINITY);
+            result.parent.assign(n, -1);
+            vector<vector<vector<int>>> buckets(threads); // buckets[owner][index] holds the owner's vertices queued in that bucket
+            vector<vector<vector<Request>>> requests(threads, vector<vector<Request>>(threads)); // requests[producer][owner]
+            auto bucketOf = [delta](double d) { return (size_t)(d / delta); };
+
+            // Relaxes the light or heavy edges leaving the given vertices into requests, then lets each owner apply its own
+            auto relax = [&](const vector<int>& from, bool light) {
+                int stepThreads = from.size() < serialWork ? 1 : threads;
+                run_parallel(stepThreads, [&](int t) {
+                    size_t first = from.size() * t / stepThreads;
+                    size_t last = from.size() * (t + 1) / stepThreads;
+                    for (size_t f = first; f < last; f++) {
+                        int u = from[f];
+                        double du = result.distance[u];
+                        for (size_t i = 0; i < adjList[u].size(); i++) {
+                            double w = weightList[u][i];
+                            if ((w <= delta) == light) {
+                                int v = adjList[u][i];
+                                requests[t][v % threads].push_back(Request{v, u, du + w});
+                            }
+                        }
                     }
+                });
+                run_parallel(stepThreads, [&](int t) {
+                    for (int owner = t; owner < threads; owner += stepThreads) { // A serial step applies every owner's requests in turn
+                        for (int producer = 0; producer < stepThreads; producer++) {
+                            for (const Request& r : requests[producer][owner]) {
+                                if (r.distance < result.distance[r.vertex]) {
+                                    result.distance[r.vertex] = r.distance;
+                                    result.parent[r.vertex] = r.from;
+                                    size_t b = bucketOf(r.distance);
+                                    if (buckets[owner].size() <= b) {
+                                        buckets[owner].resize(b + 1);
+                                    }
+                                    buckets[owner][b].push_back(r.vertex); // An older entry in another bucket is skipped as stale later
+                                }
+                            }
+                            requests[producer][owner].clear();
+                        }
+                    }
+                });
+            };
+
+            result.distance[source] = 0;
+            buckets[source % threads].resize(1);
+            buckets[source % threads][0].push_back(source);
+            vector<int> frontier; // The live vertices of the current bucket in this step
+            vector<int> settled; // Every vertex removed from the current bucket, whose heavy edges are relaxed at the end
+            vector<char> inSettled(n, 0);
+            vector<int> queuedStep(n, -1); // The step a vertex was last added to the frontier in, to drop duplicates
+            int step = 0;
+            for (size_t i = 0; ; i++) {
+                size_t next = SIZE_MAX; // Skip ahead to the lowest non-empty bucket
+                for (int t = 0; t < threads; t++) {
+                    for (size_t b = i; b < buckets[t].size() && b < next; b++) {
+                        if (!buckets[t][b].empty()) {
+                            next = b;
+                            break;
+                        }
+                    }
+                }
+                if (next == SIZE_MAX) {
+                    break; // Every bucket is empty, so every distance is final
+                }
+                i = next;
+                settled.clear();
+                while (true) { // Light edges can refill bucket i, so keep going until it stays empty
+                    frontier.clear();
+                    step++;
+                    for (int t = 0; t < threads; t++) {
+                        if (i < buckets[t].size()) {
+                            for (int v : buckets[t][i]) {
+                                if (bucketOf(result.distance[v]) == i && queuedStep[v] != step) { // Drop stale and repeated entries
+                                    queuedStep[v] = step;
+                                    frontier.push_back(v);
+                                }
+                            }
+                            buckets[t][i].clear();
+                        }
+                    }
+                    if (frontier.empty()) {
+                        break;
+                    }
+                    for (int v : frontier) {
+                        if (!inSettled[v]) {
+                            inSettled[v] = 1;
+                            settled.push_back(v);
+                        }
+                    }
+                    relax(frontier, true);
+                }
+                relax(settled, false); // Heavy edges always land in a later bucket, so one pass is enough
+                for (int v : settled) {
+                    inSettled[v] = 0;
                 }
             }
-            return false; // If the value is not found, return false
+            return result;
         }
 
-        // A helper method to search for a value in the subtree rooted at a given node using depth-first search
-        bool search(GraphNode<T>* node, T value) const {
-            node->visited = true; // Mark the node as visited
-            if (node->data == value) { // If the node's data matches the value
-                return true; // The value is found
+        // A method that answers a point-to-point query with bidirectional Dijkstra: one search grows forward from the source and
+        // another backward from the target (over incoming edges in a directed graph), always advancing the side with the smaller
+        // frontier key, and they stop once the two keys add up to at least the best path seen where the searches touch
+        Route shortestPath(int source, int target, int arity = 4) {
+            Route route;
+            route.distance = INFINITY;
+            if (source == target) {
+                route.distance = 0;
+                route.path.push_back(source);
+                return route;
             }
-            for (GraphNode<T>* neighbor : node->neighbors) { // Loop through the neighbors of the node
-                if (!neighbor->visited) { // If the neighbor has not been visited
-                    if (search(neighbor, value)) { // Recursively search for the value in the neighbor and its subtree
-                        return true; // If the value is found, return true
+            if (directed) {
+                buildInLists();
+            }
+            const vector<vector<T>>* lists[2] = { &adjList, directed ? &inList : &adjList };
+            const vector<vector<double>>* weightLists[2] = { &weightList, directed ? &inWeightList : &weightList };
+            vector<double> distance[2] = { vector<double>(numVertices, INFINITY), vector<double>(numVertices, INFINITY) };
+            vector<int> parent[2] = { vector<int>(numVertices, -1), vector<int>(numVertices, -1) };
+            vector<DaryHeap<double>> heaps;
+            heaps.emplace_back(numVertices, arity);
+            heaps.emplace_back(numVertices, arity);
+            distance[0][source] = 0;
+            distance[1][target] = 0;
+            heaps[0].push(source, 0);
+            heaps[1].push(target, 0);
+            int meet = -1; // The vertex where the best path seen crosses from the forward to the backward search
+
+            while (!heaps[0].isEmpty() && !heaps[1].isEmpty()) {
+                if (heaps[0].topKey() + heaps[1].topKey() >= route.distance) {
+                    break; // No path through an unsettled vertex can beat the best one
+                }
+                int side = heaps[0].topKey() <= heaps[1].topKey() ? 0 : 1;
+                int u = heaps[side].pop();
+                const vector<T>& out = (*lists[side])[u];
+                const vector<double>& w = (*weightLists[side])[u];
+                for (size_t i = 0; i < out.size(); i++) {
+                    int v = out[i];
+                    double nd = distance[side][u] + w[i];
+                    if (nd < distance[side][v]) {
+                        distance[side][v] = nd;
+                        parent[side][v] = u;
+                        heaps[side].push(v, nd);
+                    }
+                    if (distance[side][v] + distance[1 - side][v] < route.distance) { // The searches touch at v
+                        route.distance = distance[side][v] + distance[1 - side][v];
+                        meet = v;
                     }
                 }
             }
-            return false; // The value is not found
+
+            if (meet >= 0) { // Walk back to the source, then forward to the target
+                for (int v = meet; v != -1; v = parent[0][v]) {
+                    route.path.push_back(v);
+                }
+                std::reverse(route.path.begin(), route.path.end());
+                for (int v = parent[1][meet]; v != -1; v = parent[1][v]) {
+                    route.path.push_back(v);
+                }
+            }
+            return route;
         }
 
-        // A method to reverse the order of the edges in the graph
-        void reverse() {
-            for (GraphNode<T>* node : nodes) { // Loop through the nodes in the graph
-                std::reverse(node->neighbors.begin(), node->neighbors.end()); // Reverse the order of the neighbors vector
+        // A method that labels every vertex with its connected component (weakly connected for a directed graph) using
+        // union-find over the edges; components are numbered 0, 1, 2, ... in order of their lowest vertex
+        vector<int> connectedComponents() const {
+            DisjointSet sets(numVertices);
+            for (int u = 0; u < numVertices; u++) {
+                for (T v : adjList[u]) {
+                    sets.unite(u, v);
+                }
+            }
+            vector<int> labels(numVertices);
+            for (int v = 0; v < numVertices; v++) {
+                labels[v] = sets.find(v);
+            }
+            compactLabels(labels);
+            return labels;
+        }
+
+        // A method that labels the connected components like connectedComponents, but by parallel label propagation: every
+        // vertex starts with its own id as its label and repeatedly takes the smallest label among itself and its neighbors until
+        // nothing changes. Jumping from a label to that vertex's own label shortcuts long chains, and the number of rounds is
+        // bounded by the diameter. Labels only ever shrink to ids of the same component, so the races between rounds are benign.
+        vector<int> labelPropagationComponents(int threads = 0) {
+            if (threads <= 0) {
+                threads = max(1, (int)thread::hardware_concurrency());
+            }
+            if (directed) {
+                buildInLists(); // Weak components follow edges both ways
+            }
+            const int n = numVertices;
+            vector<atomic<int>> label(n);
+            for (int v = 0; v < n; v++) {
+                label[v].store(v, memory_order_relaxed);
+            }
+            atomic<bool> changed(true);
+            while (changed.load()) { // One round per iteration, until a round changes no label
+                changed.store(false);
+                run_parallel(threads, [&](int t) {
+                    int first = (int)((long long)n * t / threads);
+                    int last = (int)((long long)n * (t + 1) / threads);
+                    bool localChange = false;
+                    for (int v = first; v < last; v++) {
+                        int best = label[v].load(memory_order_relaxed);
+                        for (T u : adjList[v]) {
+                            best = min(best, label[u].load(memory_order_relaxed));
+                        }
+                        if (directed) {
+                            for (T u : inList[v]) {
+                                best = min(best, label[u].load(memory_order_relaxed));
+                            }
+                        }
+                        best = min(best, label[best].load(memory_order_relaxed)); // Pointer jumping
+                        if (best < label[v].load(memory_order_relaxed)) {
+                            label[v].store(best, memory_order_relaxed);
+                            localChange = true;
+                        }
+                    }
+                    if (localChange) {
+                        changed.store(true);
+                    }
+                });
+            }
+            vector<int> labels(n);
+            for (int v = 0; v < n; v++) {
+                labels[v] = label[v].load(memory_order_relaxed); // Already the lowest vertex of each component
+            }
+            compactLabels(labels);
+            return labels;
+        }
+
+        // A method that labels every vertex with its strongly connected component using an iterative version of Tarjan's
+        // algorithm, in one depth-first pass. Components are numbered in the order they complete, which is a reverse
+        // topological order of the condensation: every edge between components goes from a higher number to a lower one.
+        vector<int> tarjanScc() const {
+            const int n = numVertices;
+            vector<int> index(n, -1); // The order each vertex was discovered in, or -1 if not yet
+            vector<int> low(n, 0); // The lowest index reachable from each vertex's subtree through at most one back edge
+            vector<int> component(n, -1);
+            vector<char> onStack(n, 0);
+            vector<int> sccStack; // The vertices whose component is not yet known
+            vector<pair<int, size_t>> callStack; // The explicit recursion stack of (vertex, next neighbor index)
+            int counter = 0;
+            int components = 0;
+            for (int s = 0; s < n; s++) {
+                if (index[s] >= 0) {
+                    continue;
+                }
+                index[s] = low[s] = counter++;
+                sccStack.push_back(s);
+                onStack[s] = 1;
+                callStack.push_back(make_pair(s, (size_t)0));
+                while (!callStack.empty()) {
+                    int v = callStack.back().first;
+                    size_t& next = callStack.back().second;
+                    if (next < adjList[v].size()) {
+                        int w = adjList[v][next++];
+                        if (index[w] < 0) { // Tree edge: descend, as the recursive version would
+                            index[w] = low[w] = counter++;
+                            sccStack.push_back(w);
+                            onStack[w] = 1;
+                            callStack.push_back(make_pair(w, (size_t)0));
+                        }
+                        else if (onStack[w]) { // Back or cross edge into the current component
+                            low[v] = min(low[v], index[w]);
+                        }
+                    }
+                    else { // Every neighbor of v is done, so return from it
+                        if (low[v] == index[v]) { // v is the root of a component: pop it off the stack
+                            int w;
+                            do {
+                                w = sccStack.back();
+                                sccStack.pop_back();
+                                onStack[w] = 0;
+                                component[w] = components;
+                            } while (w != v);
+                            components++;
+                        }
+                        callStack.pop_back();
+                        if (!callStack.empty()) {
+                            int parent = callStack.back().first;
+                            low[parent] = min(low[parent], low[v]);
+                        }
+                    }
+                }
+            }
+            return component;
+        }
+
+        // A method that labels every vertex with its strongly connected component using Kosaraju's algorithm: a depth-first
+        // postorder over the edges, then searches over the reversed edges in reverse postorder, each of which collects one
+        // component. Components are numbered in topological order of the condensation, the opposite of tarjanScc.
+        vector<int> kosarajuScc() {
+            vector<int> order = sort(); // The depth-first postorder over every component
+            if (directed) {
+                buildInLists();
+            }
+            const vector<vector<T>>& reversed = directed ? inList : adjList;
+            vector<int> component(numVertices, -1);
+            vector<int> pending; // The explicit stack of the search over reversed edges
+            int components = 0;
+            for (int i = numVertices - 1; i >= 0; i--) { // Latest-finishing vertex first
+                int s = order[i];
+                if (component[s] >= 0) {
+                    continue;
+                }
+                component[s] = components;
+                pending.push_back(s);
+                while (!pending.empty()) {
+                    int u = pending.back();
+                    pending.pop_back();
+                    for (T w : reversed[u]) {
+                        if (component[w] < 0) {
+                            component[w] = components;
+                            pending.push_back(w);
+                        }
+                    }
+                }
+                components++;
+            }
+            return component;
+        }
+
+        // A method that puts the vertices in topological order with Kahn's algorithm, repeatedly taking a vertex with no
+        // remaining incoming edges. Returns false if the graph has a cycle, in which case order holds only the vertices that
+        // come before it. An undirected edge counts both ways, so only an undirected graph without edges has an order.
+        bool topologicalSort(vector<int>& order) const {
+            vector<int> indegree(numVertices, 0);
+            for (int u = 0; u < numVertices; u++) {
+                for (T v : adjList[u]) {
+                    indegree[v]++;
+                }
+            }
+            order.clear();
+            order.reserve(numVertices);
+            for (int v = 0; v < numVertices; v++) {
+                if (indegree[v] == 0) {
+                    order.push_back(v);
+                }
+            }
+            for (size_t head = 0; head < order.size(); head++) { // The output doubles as the queue, read from head onwards
+                int u = order[head];
+                for (T v : adjList[u]) {
+                    if (--indegree[v] == 0) {
+                        order.push_back(v);
+                    }
+                }
+            }
+            return (int)order.size() == numVertices;
+        }
+
+        // A method that returns the vertices sorted by decreasing degree as a permutation (perm[old] = new), so the hubs that
+        // most traversals touch share a few cache lines at the front; equal degrees keep their current relative order
+        vector<int> degreePermutation() const {
+            vector<int> byDegree(numVertices);
+            for (int v = 0; v < numVertices; v++) {
+                byDegree[v] = v;
+            }
+            stable_sort(byDegree.begin(), byDegree.end(), [this](int a, int b) { return adjList[a].size() > adjList[b].size(); });
+            return sequenceToPermutation(byDegree);
+        }
+
+        // A method that returns the reverse Cuthill-McKee ordering as a permutation (perm[old] = new). Each component is
+        // searched breadth-first from its lowest-degree vertex, enqueuing neighbors by increasing degree, and the whole
+        // sequence is reversed; neighbors end up close in number, which narrows the bandwidth of the adjacency matrix.
+        vector<int> rcmPermutation() const {
+            vector<int> byDegree(numVertices);
+            for (int v = 0; v < numVertices; v++) {
+                byDegree[v] = v;
+            }
+            stable_sort(byDegree.begin(), byDegree.end(), [this](int a, int b) { return adjList[a].size() < adjList[b].size(); });
+            vector<int> sequence;
+            sequence.reserve(numVertices);
+            vector<char> placed(numVertices, 0);
+            for (int s : byDegree) { // Each unplaced lowest-degree vertex starts a new component
+                if (placed[s]) {
+                    continue;
+                }
+                placed[s] = 1;
+                sequence.push_back(s);
+                for (size_t head = sequence.size() - 1; head < sequence.size(); head++) {
+                    size_t first = sequence.size(); // The children of this vertex, sorted once they are all in
+                    for (T w : adjList[sequence[head]]) {
+                        if (!placed[w]) {
+                            placed[w] = 1;
+                            sequence.push_back(w);
+                        }
+                    }
+                    stable_sort(sequence.begin() + first, sequence.end(), [this](int a, int b) { return adjList[a].size() < adjList[b].size(); });
+                }
+            }
+            std::reverse(sequence.begin(), sequence.end());
+            return sequenceToPermutation(sequence);
+        }
+
+        // A method that returns the breadth-first order from a given vertex as a permutation (perm[old] = new), continuing from
+        // the lowest unreached vertex for every other component, so each frontier occupies a contiguous range of ids
+        vector<int> bfsPermutation(int source = 0) const {
+            vector<int> sequence;
+            sequence.reserve(numVertices);
+            vector<char> placed(numVertices, 0);
+            for (int i = -1; i < numVertices; i++) {
+                int s = i < 0 ? source : i; // The source first, then every unreached vertex in id order
+                if (numVertices == 0 || placed[s]) {
+                    continue;
+                }
+                placed[s] = 1;
+                sequence.push_back(s);
+                for (size_t head = sequence.size() - 1; head < sequence.size(); head++) {
+                    for (T w : adjList[sequence[head]]) {
+                        if (!placed[w]) {
+                            placed[w] = 1;
+                            sequence.push_back(w);
+                        }
+                    }
+                }
+            }
+            return sequenceToPermutation(sequence);
+        }
+
+        // A method that returns a Gorder-style ordering as a permutation (perm[old] = new). Vertices are placed greedily: the next
+        // one is the unplaced vertex with the most edges to, and neighbors shared with, the last window placed vertices, so
+        // vertices that are used together are numbered together. Scores only move by one, so the candidates sit in one linked
+        // list per score (Gorder's unit heap) and every update is constant time. Vertices of degree above hubLimit are not
+        // expanded when counting shared neighbors, which keeps the cost near linear on skewed graphs, as Gorder does for hubs.
+        vector<int> gorderPermutation(int window = 5, int hubLimit = 32) const {
+            const int n = numVertices;
+            vector<int> perm(n, -1);
+            vector<int> score(n, 0); // Each unplaced vertex's affinity to the current window
+            vector<int> head(1, -1); // The first vertex of each score's list; vertices with score 0 are in no list
+            vector<int> prev(n, -1);
+            vector<int> next(n, -1);
+            int top = 0; // No list above this score is non-empty
+            auto unlink = [&](int v) {
+                if (prev[v] >= 0) {
+                    next[prev[v]] = next[v];
+                }
+                else {
+                    head[score[v]] = next[v];
+                }
+                if (next[v] >= 0) {
+                    prev[next[v]] = prev[v];
+                }
+            };
+            auto link = [&](int v) {
+                if (score[v] >= (int)head.size()) {
+                    head.resize(score[v] + 1, -1);
+                }
+                prev[v] = -1;
+                next[v] = head[score[v]];
+                if (next[v] >= 0) {
+                    prev[next[v]] = v;
+                }
+                head[score[v]] = v;
+                top = max(top, score[v]);
+            };
+            auto adjust = [&](int x, int delta) { // Moves an unplaced vertex to the neighboring score's list
+                if (score[x] > 0) {
+                    unlink(x);
+                }
+                score[x] += delta;
+                if (score[x] > 0) {
+                    link(x);
+                }
+            };
+            auto update = [&](int v, int delta) { // Adds delta to the affinity of everything v is tied to
+                for (T u : adjList[v]) {
+                    if (perm[u] < 0) {
+                        adjust(u, delta);
+                    }
+                    if ((int)adjList[u].size() <= hubLimit) {
+                        for (T x : adjList[u]) { // x and v share the neighbor u
+                            if (perm[x] < 0 && (int)x != v) {
+                                adjust(x, delta);
+                            }
+                        }
+                    }
+                }
+            };
+            vector<int> byDegree(n); // The fallback when nothing is tied to the window: the highest-degree unplaced vertex
+            for (int v = 0; v < n; v++) {
+                byDegree[v] = v;
+            }
+            stable_sort(byDegree.begin(), byDegree.end(), [this](int a, int b) { return adjList[a].size() > adjList[b].size(); });
+            size_t nextFallback = 0;
+            vector<int> sequence;
+            sequence.reserve(n);
+            for (int i = 0; i < n; i++) {
+                while (top > 0 && head[top] < 0) {
+                    top--;
+                }
+                int v;
+                if (top > 0) {
+                    v = head[top];
+                    unlink(v);
+                }
+                else {
+                    while (perm[byDegree[nextFallback]] >= 0) {
+                        nextFallback++;
+                    }
+                    v = byDegree[nextFallback];
+                }
+                perm[v] = i;
+                sequence.push_back(v);
+                update(v, 1);
+                if ((int)sequence.size() > window) { // The oldest vertex slides out of the window
+                    update(sequence[sequence.size() - 1 - window], -1);
+                }
+            }
+            return perm;
+        }
+
+        // A method that returns a copy of the graph with vertex v renamed perm[v], keeping every edge and weight; each
+        // neighbor list is sorted by its new ids so a scan walks memory in one direction
+        Graph<T> relabel(const vector<int>& perm) const {
+            if ((int)perm.size() != numVertices) {
+                throw invalid_argument("The permutation must name every vertex");
+            }
+            Graph<T> g(numVertices, directed);
+            vector<pair<T,double>> entries;
+            for (int u = 0; u < numVertices; u++) {
+                entries.clear();
+                for (size_t i = 0; i < adjList[u].size(); i++) {
+                    entries.push_back(make_pair((T)perm[adjList[u][i]], weightList[u][i]));
+                }
+                std::sort(entries.begin(), entries.end());
+                vector<T>& list = g.adjList[perm[u]];
+                vector<double>& w = g.weightList[perm[u]];
+                list.reserve(entries.size());
+                w.reserve(entries.size());
+                for (const pair<T,double>& e : entries) {
+                    list.push_back(e.first);
+                    w.push_back(e.second);
+                }
+            }
+            g.numEdges = numEdges;
+            return g;
+        }
+
+        // A method that benchmarks the graph on the engine's API and returns the microseconds taken by each method. The graph
+        // gets one vertex per data item and Erdős–Rényi edges, so it is measured on the same data sizes as the other structures:
+        // insert() adds every edge, delete() removes the newer half of the edges and adds them back, search() is a connectivity
+        // query between the first and last vertex, size() reads the edge count and sort() is a depth-first ordering
+        vector<int> get_time_taken(vector<string> api, vector<string> data) {
+            vector<int> time_for_ds;
+            vector<pair<int,int>> edges = generate_edges("erdos-renyi", (int)data.size());
+            for(auto method : api) {
+                auto start = chrono::high_resolution_clock::now();
+
+                if(method == "insert()") {
+                    for(size_t i = 0; i < edges.size(); i++){
+                        addEdge(edges[i].first, edges[i].second);
+                    }
+                }
+                else if(method == "delete()") {
+                    for(size_t i = edges.size(); i-- > edges.size()/2; ){ // Newest first, so every edge is at the back of its lists
+                        removeEdge(edges[i].first, edges[i].second);
+                    }
+                    for(size_t i = edges.size()/2; i < edges.size(); i++){
+                        addEdge(edges[i].first, edges[i].second);
+                    }
+                }
+                else if(method == "search()") {
+                    benchmark_sink = numVertices > 0 && connected(0, numVertices - 1); // Keep the result so the query is not optimized away
+                }
+                else if(method == "size()") {
+                    benchmark_sink = getNumEdges();
+                }
+                else if(method == "sort()") {
+                    benchmark_sink = sort().size();
+                }
+                auto stop = chrono::high_resolution_clock::now();
+
+                auto duration = chrono::duration_cast<chrono::microseconds>(stop - start);
+
+                time_for_ds.push_back(duration.count());
             }
+            return time_for_ds;
         }
 
+        // A static method that runs the graph workloads on a generated graph of n vertices ("erdos-renyi", "rmat" or "grid") and
+        // returns the microseconds taken by each: edge insertion, breadth-first traversal, depth-first traversal, 100 connectivity
+        // queries between random vertex pairs (each one is a search, so n of them would be quadratic), and n neighbor lookups at random vertices
+        static vector<int> get_graph_time_taken(const string& model, int n, unsigned seed = 1) {
+            vector<int> time_for_graph;
+            if (n <= 0) { // There is no vertex to start a traversal from, so every workload takes no time
+                return vector<int>(5, 0);
+            }
+            vector<pair<int,int>> edges = generate_edges(model, n, 8, seed);
+            Graph<T> graph(n);
+            mt19937 rng(seed + 1); // A different stream from the generator's, or the query pairs would be exactly the first edges
+            uniform_int_distribution<int> vertex(0, n - 1);
+            vector<int> queries(2 * (size_t)n); // The random vertices are drawn up front so the timings only cover the graph
+            for (int& q : queries) {
+                q = vertex(rng);
+            }
+
+            auto start = chrono::high_resolution_clock::now();
+            for (const pair<int,int>& e : edges) {
+                graph.addEdge(e.first, e.second);
+            }
+            auto stop = chrono::high_resolution_clock::now();
+            time_for_graph.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+            start = chrono::high_resolution_clock::now();
+            long long reached = 0;
+            graph.bfs(0, [&reached](int) { reached++; });
+            benchmark_sink = reached;
+            stop = chrono::high_resolution_clock::now();
+            time_for_graph.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+            start = chrono::high_resolution_clock::now();
+            reached = 0;
+            graph.dfs(0, [&reached](int) { reached++; });
+            benchmark_sink = reached;
+            stop = chrono::high_resolution_clock::now();
+            time_for_graph.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+            start = chrono::high_resolution_clock::now();
+            long long connectedPairs = 0;
+            for (int i = 0; i < min(n, 100); i++) {
+                connectedPairs += graph.connected(queries[2 * i], queries[2 * i + 1]);
+            }
+            benchmark_sink = connectedPairs;
+            stop = chrono::high_resolution_clock::now();
+            time_for_graph.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+            start = chrono::high_resolution_clock::now();
+            long long neighborSum = 0;
+            for (int i = 0; i < n; i++) {
+                for (T w : graph.neighbors(queries[i])) {
+                    neighborSum += w;
+                }
+            }
+            benchmark_sink = neighborSum;
+            stop = chrono::high_resolution_clock::now();
+            time_for_graph.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+            return time_for_graph;
+        }
+
+        // A static method that runs the shortest-path workloads on a generated graph of n vertices with random weights in [1, 100)
+        // and returns the microseconds taken by each: Dijkstra on a binary heap, Dijkstra on a 4-ary heap, delta-stepping on the
+        // given number of threads (0 for all cores), and 100 bidirectional point-to-point queries between random vertex pairs
+        static vector<int> get_shortest_path_time_taken(const string& model, int n, int threads = 0, unsigned seed = 1) {
+            vector<int> time_for_graph;
+            if (n <= 0) { // There is no source to search from
+                return vector<int>(4, 0);
+            }
+            vector<pair<int,int>> edges = generate_edges(model, n, 8, seed);
+            Graph<T> graph(n);
+            mt19937 rng(seed + 1);
+            uniform_real_distribution<double> weight(1.0, 100.0);
+            for (const pair<int,int>& e : edges) {
+                graph.addEdge(e.first, e.second, weight(rng));
+            }
+            uniform_int_distribution<int> vertex(0, n - 1);
+            vector<int> queries(200);
+            for (int& q : queries) {
+                q = vertex(rng);
+            }
+
+            for (int arity : {2, 4}) {
+                auto start = chrono::high_resolution_clock::now();
+                benchmark_sink = graph.dijkstra(0, arity).parent[n - 1];
+                auto stop = chrono::high_resolution_clock::now();
+                time_for_graph.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+            }
+
+            auto start = chrono::high_resolution_clock::now();
+            benchmark_sink = graph.deltaStepping(0, 0, threads).parent[n - 1];
+            auto stop = chrono::high_resolution_clock::now();
+            time_for_graph.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+            start = chrono::high_resolution_clock::now();
+            for (int i = 0; i < 100; i++) {
+                benchmark_sink = graph.shortestPath(queries[2 * i], queries[2 * i + 1]).path.size();
+            }
+            stop = chrono::high_resolution_clock::now();
+            time_for_graph.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+            return time_for_graph;
+        }
+
+        // A static method that runs the connectivity workloads on a generated graph of n vertices and returns the microseconds
+        // taken by each: union-find components and label propagation on the undirected graph, Tarjan and Kosaraju on the same
+        // edges taken as directed, and a topological sort with every edge pointed from its lower to its higher vertex
+        static vector<int> get_connectivity_time_taken(const string& model, int n, int threads = 0, unsigned seed = 1) {
+            vector<int> time_for_graph;
+            if (n <= 0) { // There are no labels to compute
+                return vector<int>(5, 0);
+            }
+            vector<pair<int,int>> edges = generate_edges(model, n, 8, seed);
+            Graph<T> undirectedGraph = fromEdgeList(n, edges);
+            Graph<T> directedGraph = fromEdgeList(n, edges, true);
+            vector<pair<int,int>> acyclic;
+            for (const pair<int,int>& e : edges) {
+                if (e.first != e.second) {
+                    acyclic.push_back(make_pair(min(e.first, e.second), max(e.first, e.second)));
+                }
+            }
+            Graph<T> dag = fromEdgeList(n, acyclic, true);
+
+            auto start = chrono::high_resolution_clock::now();
+            benchmark_sink = undirectedGraph.connectedComponents().back();
+            auto stop = chrono::high_resolution_clock::now();
+            time_for_graph.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+            start = chrono::high_resolution_clock::now();
+            benchmark_sink = undirectedGraph.labelPropagationComponents(threads).back();
+            stop = chrono::high_resolution_clock::now();
+            time_for_graph.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+            start = chrono::high_resolution_clock::now();
+            benchmark_sink = directedGraph.tarjanScc().back();
+            stop = chrono::high_resolution_clock::now();
+            time_for_graph.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+            start = chrono::high_resolution_clock::now();
+            benchmark_sink = directedGraph.kosarajuScc().back();
+            stop = chrono::high_resolution_clock::now();
+            time_for_graph.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+            start = chrono::high_resolution_clock::now();
+            vector<int> order;
+            benchmark_sink = dag.topologicalSort(order);
+            stop = chrono::high_resolution_clock::now();
+            time_for_graph.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+            return time_for_graph;
+        }
+
+        // A static method that measures how vertex numbering affects traversal speed. It numbers a generated graph of n vertices
+        // at random, as arbitrary insertion order would, then returns one row per ordering (as given, by degree, reverse
+        // Cuthill-McKee, breadth-first and Gorder-style) holding the microseconds to compute and apply the ordering and the
+        // microseconds for a breadth-first search plus a depth-first ordering of the relabeled graph
+        static vector<vector<int>> get_reorder_time_taken(const string& model, int n, unsigned seed = 1) {
+            if (n <= 0) { // There is nothing to number or traverse
+                return vector<vector<int>>(5, vector<int>(2, 0));
+            }
+            vector<pair<int,int>> edges = generate_edges(model, n, 8, seed);
+            vector<int> shuffle(n);
+            for (int v = 0; v < n; v++) {
+                shuffle[v] = v;
+            }
+            mt19937 rng(seed + 1);
+            std::shuffle(shuffle.begin(), shuffle.end(), rng);
+            for (pair<int,int>& e : edges) {
+                e = make_pair(shuffle[e.first], shuffle[e.second]);
+            }
+            Graph<T> original = fromEdgeList(n, edges);
+            int source = shuffle[0];
+
+            vector<vector<int>> rows;
+            for (int ordering = 0; ordering < 5; ordering++) {
+                auto start = chrono::high_resolution_clock::now();
+                vector<int> perm;
+                if (ordering == 0) {
+                    perm.resize(n); // The identity, so the baseline is relabeled (and its neighbor lists sorted) like the others
+                    for (int v = 0; v < n; v++) {
+                        perm[v] = v;
+                    }
+                }
+                else if (ordering == 1) {
+                    perm = original.degreePermutation();
+                }
+                else if (ordering == 2) {
+                    perm = original.rcmPermutation();
+                }
+                else if (ordering == 3) {
+                    perm = original.bfsPermutation(source);
+                }
+                else {
+                    perm = original.gorderPermutation();
+                }
+                Graph<T> g = original.relabel(perm);
+                auto stop = chrono::high_resolution_clock::now();
+                int reorderTime = chrono::duration_cast<chrono::microseconds>(stop - start).count();
+
+                start = chrono::high_resolution_clock::now();
+                long long reached = 0;
+                g.bfs(perm[source], [&reached](int) { reached++; });
+                benchmark_sink = reached + (long long)g.sort().size();
+                stop = chrono::high_resolution_clock::now();
+                rows.push_back({reorderTime, (int)chrono::duration_cast<chrono::microseconds>(stop - start).count()});
+            }
+            return rows;
+        }
+};
+
+// The capabilities and costs the search engine matches workloads against
+template <class T>
+struct container_traits<Graph<T>> {
+    static constexpr const char* name = "graphs";
+    static constexpr unsigned capabilities = GraphQueries;
+    // Inserting adds an edge, deleting scans one adjacency list and searching is a traversal
+    static constexpr Complexity insertCost = Complexity::Constant;
+    static constexpr Complexity deleteCost = Complexity::Linear;
+    static constexpr Complexity searchCost = Complexity::Linear;
+
+    static constexpr double bytesPerElement(double) {
+        return 8 * sizeof(int) * 2 + sizeof(vector<int>) * 2; // Neighbors and weights at the benchmark's average degree of 8
+    }
 
+    static Graph<T> make(size_t n) {
+        return Graph<T>((int)n); // One vertex per data item
+    }
 };
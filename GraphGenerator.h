@@ -0,0 +1,87 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <random>
+#include <cmath>
+#include <utility>
+#include <stdexcept>
+using namespace std;
+
+// Generators for the edge lists the graph benchmarks run on. Every generator is seeded, so the same
+// arguments always give the same graph and different data structures are compared on identical input.
+
+// A function that returns m edges between uniformly random vertex pairs among n vertices (Erdős–Rényi G(n, m))
+inline vector<pair<int,int>> erdos_renyi_edges(int n, long long m, unsigned seed = 1) {
+    vector<pair<int,int>> edges;
+    if (n <= 0) { // There are no vertices to join
+        return edges;
+    }
+    edges.reserve(m);
+    mt19937 rng(seed);
+    uniform_int_distribution<int> vertex(0, n - 1);
+    for (long long e = 0; e < m; e++) {
+        edges.push_back(make_pair(vertex(rng), vertex(rng)));
+    }
+    return edges;
+}
+
+// A function that returns m edges from the recursive matrix (R-MAT) model, which gives the skewed, power-law degrees of
+// social and web graphs: each edge picks one quadrant of the adjacency matrix per bit with probabilities a, b, c and 1 - a - b - c
+inline vector<pair<int,int>> rmat_edges(int n, long long m, unsigned seed = 1, double a = 0.57, double b = 0.19, double c = 0.19) {
+    int scale = 0; // The number of bits needed to number n vertices
+    while ((1LL << scale) < n) {
+        scale++;
+    }
+    vector<pair<int,int>> edges;
+    if (n <= 0) { // No edge could land inside the vertex range, so the loop below would never end
+        return edges;
+    }
+    edges.reserve(m);
+    mt19937 rng(seed);
+    uniform_real_distribution<double> coin(0.0, 1.0);
+    while ((long long)edges.size() < m) {
+        long long u = 0;
+        long long v = 0;
+        for (int bit = 0; bit < scale; bit++) { // Descend one level of the matrix per bit
+            double r = coin(rng);
+            int row = (r >= a + b) ? 1 : 0; // Bottom half for quadrants c and d
+            int col = (r >= a && r < a + b) || r >= a + b + c ? 1 : 0; // Right half for quadrants b and d
+            u = (u << 1) | row;
+            v = (v << 1) | col;
+        }
+        if (u < n && v < n) { // Drop edges that land outside the vertex range when n is not a power of two
+            edges.push_back(make_pair((int)u, (int)v));
+        }
+    }
+    return edges;
+}
+
+// A function that returns the edges of a near-square grid of n vertices, each joined to its right and lower neighbor
+inline vector<pair<int,int>> grid_edges(int n) {
+    int cols = max(1, (int)sqrt((double)n)); // The width of the grid; the last row may be partial
+    vector<pair<int,int>> edges;
+    for (int v = 0; v < n; v++) {
+        if ((v + 1) % cols != 0 && v + 1 < n) { // Right neighbor in the same row
+            edges.push_back(make_pair(v, v + 1));
+        }
+        if (v + cols < n) { // Neighbor in the next row
+            edges.push_back(make_pair(v, v + cols));
+        }
+    }
+    return edges;
+}
+
+// A function that returns the edges of a named model: "erdos-renyi" and "rmat" get averageDegree / 2 edges per vertex, "grid" is a lattice
+inline vector<pair<int,int>> generate_edges(const string& model, int n, int averageDegree = 8, unsigned seed = 1) {
+    long long m = (long long)n * averageDegree / 2; // Every undirected edge adds two to the degree sum
+    if (model == "erdos-renyi") {
+        return erdos_renyi_edges(n, m, seed);
+    }
+    else if (model == "rmat") {
+        return rmat_edges(n, m, seed);
+    }
+    else if (model == "grid") {
+        return grid_edges(n);
+    }
+    throw invalid_argument("Unknown graph model " + model);
+}
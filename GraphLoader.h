@@ -0,0 +1,321 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <stdexcept>
+#include "MappedFile.h"
+#include "CSRGraph.h"
+#include "Graph.h"
+#include "GraphGenerator.h"
+using namespace std;
+
+// Loaders that turn edge-list files into graphs. A text edge list has one edge per line, "u v" or "u v weight", separated
+// by spaces or tabs; lines starting with '#' or '%' are comments, as in the SNAP and Matrix Market collections. A binary
+// edge list is a flat array of little-endian 32-bit (u, v) pairs. Vertex ids are 0-based and the vertex count is one more
+// than the largest id seen.
+
+// The edges read from a file, with the weights at the same indexes when the file had any
+struct EdgeList {
+    int numVertices;
+    vector<pair<int,int>> edges;
+    vector<double> weights; // Empty when no line had a weight
+};
+
+// A helper function that parses a non-negative decimal integer at p, moving p past it; returns false if there are no digits
+inline bool parse_vertex(const char*& p, const char* end, int& value) {
+    if (p == end || *p < '0' || *p > '9') {
+        return false;
+    }
+    long long v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 + (*p - '0');
+        p++;
+    }
+    if (v > INT32_MAX) {
+        throw runtime_error("Vertex id " + to_string(v) + " does not fit in an int");
+    }
+    value = (int)v;
+    return true;
+}
+
+// A helper function that parses a decimal number such as 3, -0.25 or 1.5e3 at p, moving p past it; returns false if there
+// is no number. The mapped file is not null-terminated, so strtod cannot be used safely at its end.
+inline bool parse_weight(const char*& p, const char* end, double& value) {
+    const char* start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    double v = 0;
+    bool digits = false;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 + (*p - '0');
+        p++;
+        digits = true;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        double scale = 0.1;
+        while (p < end && *p >= '0' && *p <= '9') {
+            v += (*p - '0') * scale;
+            scale *= 0.1;
+            p++;
+            digits = true;
+        }
+    }
+    if (!digits) {
+        p = start;
+        return false;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negativeExponent = *p == '-';
+            p++;
+        }
+        int exponent = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            exponent = min(exponent * 10 + (*p - '0'), 400); // Anything larger overflows a double anyway
+            p++;
+        }
+        v *= pow(10.0, negativeExponent ? -exponent : exponent);
+    }
+    value = negative ? -v : v;
+    return true;
+}
+
+// A helper function that parses the text edge lines from begin up to end into the given vectors, returning the largest
+// vertex id seen (-1 if none). Weights are only stored once some line carries one, so an unweighted file costs no weight
+// memory; weighted is set when that happens, and the earlier lines are back-filled with weight 1.
+inline int parse_edge_lines(const char* begin, const char* end, vector<pair<int,int>>& edges, vector<double>& weights, bool& weighted) {
+    int maxVertex = -1;
+    const char* p = begin;
+    while (p < end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            p++;
+        }
+        int u, v;
+        if (p < end && *p != '\n' && *p != '#' && *p != '%') {
+            if (!parse_vertex(p, end, u)) {
+                throw runtime_error("Malformed edge line: expected a vertex id");
+            }
+            while (p < end && (*p == ' ' || *p == '\t')) {
+                p++;
+            }
+            if (!parse_vertex(p, end, v)) {
+                throw runtime_error("Malformed edge line: expected a second vertex id");
+            }
+            while (p < end && (*p == ' ' || *p == '\t')) {
+                p++;
+            }
+            double w = 1.0;
+            if (parse_weight(p, end, w) && !weighted) {
+                weights.assign(edges.size(), 1.0);
+                weighted = true;
+            }
+            if (weighted) {
+                weights.push_back(w);
+            }
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+                p++;
+            }
+            if (p < end && *p != '\n' && *p != '#' && *p != '%') { // Only a comment may follow the weight
+                throw runtime_error("Malformed edge line: unexpected text after the edge");
+            }
+            edges.push_back(make_pair(u, v));
+            maxVertex = max(maxVertex, max(u, v));
+        }
+        while (p < end && *p != '\n') { // Skip the rest of the line, including comments
+            p++;
+        }
+        p++;
+    }
+    return maxVertex;
+}
+
+// A function that parses a text edge list held in memory on several threads (0 for all cores). The buffer is cut into
+// equal chunks moved forward to the next line start, each thread parses its own chunk, and the results are stitched back
+// together in file order.
+inline EdgeList parse_edge_list(const char* data, size_t size, int threads = 0) {
+    if (threads <= 0) {
+        threads = max(1, (int)thread::hardware_concurrency());
+    }
+    const size_t minChunk = 1 << 20; // Smaller pieces are not worth a thread
+    threads = (int)max((size_t)1, min((size_t)threads, size / minChunk));
+
+    vector<size_t> cut(threads + 1); // Chunk t covers [cut[t], cut[t + 1]), always starting at a line start
+    cut[0] = 0;
+    cut[threads] = size;
+    for (int t = 1; t < threads; t++) {
+        size_t c = max(cut[t - 1], size * t / threads);
+        while (c < size && c > 0 && data[c - 1] != '\n') {
+            c++;
+        }
+        cut[t] = c;
+    }
+
+    vector<vector<pair<int,int>>> partEdges(threads);
+    vector<vector<double>> partWeights(threads);
+    vector<int> partMax(threads, -1);
+    vector<char> partWeighted(threads, 0);
+    vector<string> partError(threads); // An exception cannot cross the thread boundary, so it is carried back as text
+    run_parallel(threads, [&](int t) {
+        try {
+            bool weighted = false;
+            partMax[t] = parse_edge_lines(data + cut[t], data + cut[t + 1], partEdges[t], partWeights[t], weighted);
+            partWeighted[t] = weighted;
+        }
+        catch (const exception& e) {
+            partError[t] = e.what();
+        }
+    });
+    for (const string& error : partError) {
+        if (!error.empty()) {
+            throw runtime_error(error);
+        }
+    }
+
+    EdgeList list;
+    list.numVertices = 0;
+    vector<size_t> start(threads + 1, 0); // Where each chunk's edges go in the stitched list
+    bool weighted = false;
+    for (int t = 0; t < threads; t++) {
+        start[t + 1] = start[t] + partEdges[t].size();
+        list.numVertices = max(list.numVertices, partMax[t] + 1);
+        weighted = weighted || partWeighted[t];
+    }
+    list.edges.resize(start[threads]);
+    if (weighted) {
+        list.weights.resize(start[threads]);
+    }
+    run_parallel(threads, [&](int t) {
+        copy(partEdges[t].begin(), partEdges[t].end(), list.edges.begin() + start[t]);
+        if (weighted && partWeighted[t]) {
+            copy(partWeights[t].begin(), partWeights[t].end(), list.weights.begin() + start[t]);
+        }
+        else if (weighted) { // This chunk had no weights of its own
+            fill(list.weights.begin() + start[t], list.weights.begin() + start[t + 1], 1.0);
+        }
+        vector<pair<int,int>>().swap(partEdges[t]); // Free each chunk as soon as it is copied
+        vector<double>().swap(partWeights[t]);
+    });
+    return list;
+}
+
+// A function that maps a text edge-list file and parses it on several threads (0 for all cores)
+inline EdgeList load_text_edge_list(const string& path, int threads = 0) {
+    MappedFile file(path);
+    return parse_edge_list(file.data(), file.size(), threads);
+}
+
+// A function that maps a binary edge-list file of 32-bit (u, v) pairs and converts it on several threads (0 for all cores)
+inline EdgeList load_binary_edge_list(const string& path, int threads = 0) {
+    MappedFile file(path);
+    if (file.size() % (2 * sizeof(int32_t)) != 0) {
+        throw runtime_error(path + " is not a whole number of 32-bit edge pairs");
+    }
+    if (threads <= 0) {
+        threads = max(1, (int)thread::hardware_concurrency());
+    }
+    size_t m = file.size() / (2 * sizeof(int32_t));
+    EdgeList list;
+    list.edges.resize(m);
+    vector<int> partMax(threads, -1);
+    vector<char> partNegative(threads, 0); // Whether a chunk held a negative id, which cannot index a vertex
+    run_parallel(threads, [&](int t) {
+        size_t first = m * t / threads;
+        size_t last = m * (t + 1) / threads;
+        int32_t pair[2];
+        for (size_t e = first; e < last; e++) {
+            memcpy(pair, file.data() + e * sizeof(pair), sizeof(pair)); // The mapping is page aligned, but memcpy keeps this portable
+            if (pair[0] < 0 || pair[1] < 0) {
+                partNegative[t] = 1;
+                return;
+            }
+            list.edges[e] = make_pair((int)pair[0], (int)pair[1]);
+            partMax[t] = max(partMax[t], max((int)pair[0], (int)pair[1]));
+        }
+    });
+    list.numVertices = 0;
+    for (int t = 0; t < threads; t++) {
+        if (partNegative[t]) {
+            throw runtime_error(path + " has a negative vertex id");
+        }
+        list.numVertices = max(list.numVertices, partMax[t] + 1);
+    }
+    return list;
+}
+
+// A function that loads a text edge list (or a binary one if the path ends in ".bin") straight into compressed sparse row form
+inline CSRGraph<int> load_csr_graph(const string& path, bool directed = false, int threads = 0) {
+    bool binary = path.size() >= 4 && path.compare(path.size() - 4, 4, ".bin") == 0;
+    EdgeList list = binary ? load_binary_edge_list(path, threads) : load_text_edge_list(path, threads);
+    return CSRGraph<int>::fromEdgeList(list.numVertices, list.edges, directed, threads);
+}
+
+// A function that loads a text edge list (or a binary one if the path ends in ".bin") into an adjacency-list graph, keeping
+// any weights the file carries
+inline Graph<int> load_graph(const string& path, bool directed = false, int threads = 0) {
+    bool binary = path.size() >= 4 && path.compare(path.size() - 4, 4, ".bin") == 0;
+    EdgeList list = binary ? load_binary_edge_list(path, threads) : load_text_edge_list(path, threads);
+    return Graph<int>::fromEdgeList(list.numVertices, list.edges, directed, list.weights);
+}
+
+// A function that writes edges as a text edge list, one "u v" line per edge
+inline void save_text_edge_list(const string& path, const vector<pair<int,int>>& edges) {
+    ofstream out(path, ios::trunc);
+    if (!out) {
+        throw runtime_error("Cannot write " + path);
+    }
+    string buffer; // Formatting into one string is much faster than streaming every number
+    buffer.reserve(edges.size() * 16);
+    for (const pair<int,int>& e : edges) {
+        buffer += to_string(e.first);
+        buffer += ' ';
+        buffer += to_string(e.second);
+        buffer += '\n';
+    }
+    out.write(buffer.data(), buffer.size());
+}
+
+// A function that benchmarks loading a generated graph of n vertices written to a scratch file and returns the microseconds
+// taken by each step: parsing the text edge list, building the compressed sparse row graph, saving a snapshot and loading
+// the snapshot back
+inline vector<int> get_load_time_taken(const string& model, int n, int threads = 0, const string& scratch = "graph_load_benchmark") {
+    vector<int> time_for_load;
+    string textPath = scratch + ".txt";
+    string snapshotPath = scratch + ".csr";
+    save_text_edge_list(textPath, generate_edges(model, n));
+
+    auto start = chrono::high_resolution_clock::now();
+    EdgeList list = load_text_edge_list(textPath, threads);
+    auto stop = chrono::high_resolution_clock::now();
+    time_for_load.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+    start = chrono::high_resolution_clock::now();
+    CSRGraph<int> g = CSRGraph<int>::fromEdgeList(list.numVertices, list.edges, false, threads);
+    stop = chrono::high_resolution_clock::now();
+    time_for_load.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+    start = chrono::high_resolution_clock::now();
+    g.saveSnapshot(snapshotPath);
+    stop = chrono::high_resolution_clock::now();
+    time_for_load.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+    start = chrono::high_resolution_clock::now();
+    CSRGraph<int> reloaded = CSRGraph<int>::loadSnapshot(snapshotPath);
+    stop = chrono::high_resolution_clock::now();
+    time_for_load.push_back(chrono::duration_cast<chrono::microseconds>(stop - start).count());
+
+    remove(textPath.c_str());
+    remove(snapshotPath.c_str());
+    return time_for_load;
+}
@@ -1,8 +1,12 @@
+#pragma once
 #include <iostream>
 #include <vector>
 #include <string>
 #include <chrono>
 #include <list>
+#include <algorithm>
+#include <stdexcept>
+#include "ContainerTraits.h"
 using namespace std;
 
 // A class template for hash table nodes
@@ -25,6 +29,7 @@ class HashTable {
     private:
         int capacity; // The maximum number of buckets in the table
         int size; // The current number of nodes in the table
+        double maxLoadFactor; // The average number of nodes per bucket above which the table grows
         vector<list<HashNode<K,V>>> table; // The vector of lists to store the nodes
 
         // A helper method that returns the hash value of a given key
@@ -33,11 +38,40 @@ class HashTable {
         }
 
     public:
-        // A constructor that creates a hash table with a given capacity and no nodes
-        HashTable(int c) {
-            capacity = c;
+        // A constructor that creates a hash table with a given capacity and no nodes, which doubles its buckets whenever the
+        // average chain grows longer than a given load factor. Throws invalid_argument if the load factor is not positive,
+        // since the table would then double on every insert.
+        HashTable(int c, double loadFactor = 1.0) {
+            if (!(loadFactor > 0)) { // Also rejects NaN
+                throw invalid_argument("The load factor of a hash table must be positive");
+            }
+            capacity = max(1, c);
             size = 0;
-            table.resize(c); // Resize the vector of lists to have c lists, one for each bucket
+            maxLoadFactor = loadFactor;
+            table.resize(capacity); // Resize the vector of lists to have c lists, one for each bucket
+        }
+
+        // A method that returns the current number of buckets
+        int getBucketCount() const {
+            return capacity;
+        }
+
+        // A method that returns the average number of nodes per bucket
+        double getLoadFactor() const {
+            return (double)size / capacity;
+        }
+
+        // A method that moves every node into a new table with a given number of buckets
+        void rehash(int c) {
+            vector<list<HashNode<K,V>>> old(max(1, c));
+            old.swap(table); // The table now has the new empty buckets and old holds the nodes
+            capacity = (int)table.size();
+            for (auto& bucket : old) {
+                while (!bucket.empty()) { // Splice each node across, so no node is copied or reallocated
+                    int index = hashFunction(bucket.front().key);
+                    table[index].splice(table[index].begin(), bucket, bucket.begin());
+                }
+            }
         }
 
         // A method that returns the current number of nodes in the table
@@ -62,6 +96,9 @@ class HashTable {
             // If the loop ends without finding a matching key, create a new node with the given key and value and add it to the front of the bucket
             table[index].push_front(HashNode<K,V>(key, value));
             size++; // Increment the size by one
+            if (size > capacity * maxLoadFactor) { // Chains are getting long, so spread the nodes over twice the buckets
+                rehash(capacity * 2);
+            }
         }
 
         // A method that removes a node with a given key from the table, throwing an exception if it does not exist
@@ -131,7 +168,8 @@ class HashTable {
                     
                 }
                 else if(method == "search()") {
-                    search(50);
+                    size_t middle = data.size() / 2; // A key the insert() pass stored, whatever the size
+                    benchmark_sink = !data.empty() && search(middle) == data.at(middle);
                 }
                 else if(method == "size()") {
                     int x = getSize();
@@ -151,3 +189,34 @@ class HashTable {
             return time_for_ds;
         }
 };
+
+// The capabilities and costs the search engine matches workloads against
+template <class K, class V>
+struct container_traits<HashTable<K, V>> {
+    static constexpr const char* name = "hash table";
+    static constexpr unsigned capabilities = Elements | RandomAccess | Iteration;
+    // Costs are expected ones, assuming the hash spreads the keys over the buckets
+    static constexpr Complexity insertCost = Complexity::Constant;
+    static constexpr Complexity deleteCost = Complexity::Constant;
+    static constexpr Complexity searchCost = Complexity::Constant;
+
+    static constexpr double bytesPerElement(double elementBytes) {
+        return elementBytes + sizeof(K) + 2 * sizeof(void*) + 16; // The key and value node in a chain plus its bucket slot
+    }
+
+    static HashTable<K, V> make(size_t) {
+        return HashTable<K, V>(5);
+    }
+
+    static vector<TuningParameter> tuningSpace(size_t n) {
+        double buckets = (double)max((size_t)1, n);
+        return {
+            {"buckets", 5, {5, max(5.0, buckets / 8), max(5.0, buckets / 2), buckets, 2 * buckets}},
+            {"load factor", 1, {1, 0.5, 2, 4, 8}}
+        };
+    }
+
+    static HashTable<K, V> make(size_t, const vector<double>& setting) {
+        return HashTable<K, V>((int)setting[0], setting[1]);
+    }
+};
@@ -0,0 +1,132 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+using namespace std;
+
+// A class for safe memory reclamation in lock-free structures using hazard pointers.
+// Before dereferencing a shared node a thread publishes its address in its hazard slot;
+// a removed node is retired instead of deleted and only freed once no slot holds it.
+class HazardPointers {
+    public:
+        static const int MAX_THREADS = 128; // The number of threads that can hold a hazard slot at once
+
+    private:
+        // A slot owned by one thread, padded to its own cache line so publishing does not false-share
+        struct alignas(64) Slot {
+            atomic<void*> pointer; // The node the owning thread is currently reading, or null
+            atomic<bool> owned; // Whether a live thread has claimed this slot
+        };
+
+        // A node waiting to be freed together with the function that frees it
+        struct Retired {
+            void* pointer;
+            void (*deleter)(void*);
+        };
+
+        // The per-thread state: the claimed slot and the nodes this thread has retired
+        struct ThreadRecord {
+            int slot;
+            vector<Retired> retired;
+
+            ThreadRecord() {
+                slot = domain().claimSlot();
+            }
+
+            // On thread exit, free what can be freed and hand the rest to the shared orphan list
+            ~ThreadRecord() {
+                domain().slots[slot].pointer.store(nullptr);
+                domain().scan(retired);
+                if (!retired.empty()) {
+                    lock_guard<mutex> lock(domain().orphanLock);
+                    domain().orphans.insert(domain().orphans.end(), retired.begin(), retired.end());
+                }
+                domain().slots[slot].owned.store(false);
+            }
+        };
+
+        Slot slots[MAX_THREADS]; // One hazard slot per thread
+        mutex orphanLock; // Protects the orphan list
+        vector<Retired> orphans; // Retired nodes left behind by threads that have exited
+
+        HazardPointers() {
+            for (int i = 0; i < MAX_THREADS; i++) {
+                slots[i].pointer.store(nullptr);
+                slots[i].owned.store(false);
+            }
+        }
+
+        // A helper method that claims a free slot for the calling thread, throwing an exception if all are taken
+        int claimSlot() {
+            for (int i = 0; i < MAX_THREADS; i++) {
+                bool expected = false;
+                if (!slots[i].owned.load() && slots[i].owned.compare_exchange_strong(expected, true)) {
+                    return i;
+                }
+            }
+            throw runtime_error("Too many threads for hazard pointers");
+        }
+
+        // A helper method that frees every node in a list that no thread has published, keeping the rest
+        void scan(vector<Retired>& list) {
+            vector<void*> hazards; // A snapshot of every published pointer
+            for (int i = 0; i < MAX_THREADS; i++) {
+                void* p = slots[i].pointer.load();
+                if (p != nullptr) {
+                    hazards.push_back(p);
+                }
+            }
+            std::sort(hazards.begin(), hazards.end()); // Sort once so each lookup is a binary search
+            size_t kept = 0;
+            for (size_t i = 0; i < list.size(); i++) {
+                if (binary_search(hazards.begin(), hazards.end(), list[i].pointer)) { // Still being read, keep it for a later scan
+                    list[kept++] = list[i];
+                }
+                else {
+                    list[i].deleter(list[i].pointer);
+                }
+            }
+            list.resize(kept);
+        }
+
+        // A helper method that returns the calling thread's record, creating it on first use
+        static ThreadRecord& record() {
+            thread_local ThreadRecord rec;
+            return rec;
+        }
+
+    public:
+        // A method that returns the process-wide hazard pointer domain
+        static HazardPointers& domain() {
+            static HazardPointers instance;
+            return instance;
+        }
+
+        // A method that publishes a pointer the calling thread is about to dereference
+        static void protect(void* p) {
+            domain().slots[record().slot].pointer.store(p); // Sequentially consistent, so the caller's re-read cannot move before it
+        }
+
+        // A method that clears the calling thread's published pointer
+        static void clear() {
+            domain().slots[record().slot].pointer.store(nullptr, memory_order_release);
+        }
+
+        // A method that hands a removed node over for deferred freeing, scanning once enough nodes have piled up
+        template <class Node>
+        static void retire(Node* node) {
+            ThreadRecord& rec = record();
+            rec.retired.push_back(Retired{node, [](void* p) { delete static_cast<Node*>(p); }});
+            if (rec.retired.size() >= 2 * MAX_THREADS) { // Amortize each scan over many retirements
+                {
+                    lock_guard<mutex> lock(domain().orphanLock); // Adopt nodes left behind by exited threads
+                    rec.retired.insert(rec.retired.end(), domain().orphans.begin(), domain().orphans.end());
+                    domain().orphans.clear();
+                }
+                domain().scan(rec.retired);
+            }
+        }
+};
@@ -1,7 +1,9 @@
+#pragma once
 #include <iostream>
 #include <vector>
 #include <string>
 #include <chrono>
+#include "ContainerTraits.h"
 
 using namespace std;
 
@@ -293,7 +295,7 @@ class LinkedList {
                     
                 }
                 else if(method == "search()") {
-                    search(data.back());
+                    benchmark_sink = search(data.back()); // Keep the result so the scan is not optimized away
                 }
                 else if(method == "size()") {
                     int x = getSize();
@@ -310,3 +312,22 @@ class LinkedList {
             return time_for_ds;
         }
 };
+
+// The capabilities and costs the search engine matches workloads against
+template <class T>
+struct container_traits<LinkedList<T>> {
+    static constexpr const char* name = "linked list";
+    static constexpr unsigned capabilities = Elements | SortedOrder | InsertionOrder | FifoOrder | LifoOrder | Iteration;
+    // Either end can be taken out, and deleting a given key first has to find it
+    static constexpr Complexity insertCost = Complexity::Constant;
+    static constexpr Complexity deleteCost = Complexity::Linear;
+    static constexpr Complexity searchCost = Complexity::Linear;
+
+    static constexpr double bytesPerElement(double elementBytes) {
+        return elementBytes + sizeof(void*) + 16; // The node, its next pointer and the allocator's overhead
+    }
+
+    static LinkedList<T> make(size_t) {
+        return LinkedList<T>();
+    }
+};
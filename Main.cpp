@@ -2,199 +2,425 @@
 #include <vector>
 #include <string>
 #include <numeric>
+#include <climits>
+#include <cstdlib>
+#include <new>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
 #include "Main.h"
-#include "ToArray.h"
-#include "Stack.h"
-#include "Queue.h"
-#include "LinkedList.h"
-#include "Hash Table.h"
-#include "BST.h"
+#include "ContainerRegistry.h"
+#include "ConcurrentBenchmark.h"
+#include "Ranking.h"
+#include "BenchmarkRace.h"
+#include "Recommender.h"
+#include "AutoTuner.h"
+#include "RecommendationServer.h"
+#include "BatchRunner.h"
+#include "BenchmarkSuite.h"
 
 using namespace std;
 
-vector<string> get_possible_data_structures(vector<string> api) {
-        // A vector to store the possible data structures
-        vector<string> result;
-
-        // A flag to indicate if the API requires random access
-        bool random_access = false;
-
-        // A flag to indicate if the API requires sorting
-        bool sorting = false;
-
-        // A flag to indicate if the API requires insertion or deletion at any position
-        bool insertion_deletion = false;
-
-        // A flag to indicate if the API requires ordered data
-        bool ordered_data = false;
-
-        // Parse the API string and set the flags accordingly
-        // This is a simplified example, you may need to use more sophisticated parsing techniques
-
-        for(auto method : api) {
-            if (method == "random access") {
-                random_access = true;
-            }
-            if (method == "sorting") {
-                sorting = true;
-            }
-            if (method == "insertion" || method == "deletion") {
-                insertion_deletion = true;
-            }
-            if (method == "ordered") {
-                ordered_data = true;
-            }
-        }
-
-
-        if (!random_access && !sorting && !insertion_deletion && !ordered_data) {
-            // No specific requirement, any data structure can be used
-            result.push_back("array");
-            result.push_back("stack");
-            result.push_back("queue");
-            result.push_back("linked list");
-            result.push_back("tree");
-            result.push_back("hash table");
-            result.push_back("graphs");
-        } else if (random_access && !sorting && !insertion_deletion && !ordered_data) {
-            // Only random access required, array, vector, and hash table can be used
-            result.push_back("array");
-            result.push_back("hash table");
-        } else if (!random_access && sorting && !insertion_deletion && !ordered_data) {
-            // Only sorting required, linked list and tree can be used
-            result.push_back("linked list");
-            result.push_back("tree");
-        } else if (!random_access && !sorting && insertion_deletion && !ordered_data) {
-            // Only insertion or deletion required, linked list and hash table can be used
-            result.push_back("stack");
-            result.push_back("queue");
-            result.push_back("linked list");
-            result.push_back("hash table");
-        } else if (!random_access && !sorting && !insertion_deletion && ordered_data) {
-            // Only ordered data required, array, vector, linked list, and tree can be used
-            result.push_back("array");
-            result.push_back("stack");
-            result.push_back("queue");
-            result.push_back("linked list");
-            result.push_back("tree");
-        } else if (random_access && sorting && !insertion_deletion && !ordered_data) {
-            // Random access and sorting required, array and vector can be used
-            result.push_back("array");
-        } else if (random_access && !sorting && insertion_deletion && !ordered_data) {
-            // Random access and insertion or deletion required, vector and hash table can be used
-            result.push_back("hash table");
-        } else if (random_access && !sorting && !insertion_deletion && ordered_data) {
-            // Random access and ordered data required, array and vector can be used
-            result.push_back("array");
-        } else if (!random_access && sorting && insertion_deletion && !ordered_data) {
-            // Sorting and insertion or deletion required, linked list and tree can be used
-            result.push_back("linked list"); 
-            result.push_back("tree"); 
-        } else if (!random_access && sorting && !insertion_deletion && ordered_data) { 
-            // Sorting and ordered data required, linked list and tree can be used 
-            result.push_back("linked list"); 
-            result.push_back("tree"); 
-        } else if (!random_access && !sorting && insertion_deletion && ordered_data) { 
-            // Insertion or deletion and ordered data required, linked list and tree can be used 
-            result.push_back("linked list"); 
-            result.push_back("tree"); 
-        } else if (random_access && sorting && insertion_deletion && !ordered_data) { 
-            // Random access, sorting, and insertion or deletion required, no suitable data structure exists 
-            result.clear(); 
-        } else if (random_access && sorting && !insertion_deletion && ordered_data) { 
-            // Random access, sorting, and ordered data required, array and vector can be used 
-            result.push_back("array"); 
-        } else if (random_access && !sorting && insertion_deletion && ordered_data) { 
-            // Random access, insertion or deletion, and ordered data required, no suitable data structure exists 
-            result.clear(); 
-        }
-
-        // Return the vector of possible data structures 
-        return result; 
-    }
-
-// template <class T>
-vector<vector<int>> get_full_time_taken(vector<string> data_structures, vector<string> api, vector<string> data) {
-    vector<vector<int>> time_taken;
-
-    for(auto ds : data_structures) {
-        if(ds == "array"){
-            ToArray<std::string> arr;
-            time_taken.push_back(arr.get_time_taken(api, data));
-        }
-        else if(ds == "stack"){
-            Stack<string> st;
-            time_taken.push_back(st.get_time_taken(api, data));
-        }
-        else if(ds == "queue") {
-            DynamicQueue<string> qu;
-            time_taken.push_back(qu.get_time_taken(api, data));
-        }
-        else if(ds == "linked list") {
-            LinkedList<string> linked;
-            time_taken.push_back(linked.get_time_taken(api, data));
-        }
-        else if(ds == "hash table") {
-            HashNode<int, string> node(10, "rew");
-            HashTable<int, string> ht(5);
-            time_taken.push_back(ht.get_time_taken(api, data));
-        }
-        else if(ds == "BST") {
-            BST<string> tree;
-            time_taken.push_back(tree.get_time_taken(api, data));
-        }
-    }
-    return time_taken;
+// Replace the global allocation functions so the ranking can count allocations and the bytes each container holds.
+// Every block carries its size in a header that keeps the returned pointer aligned for any type.
+static const size_t allocation_header = alignof(max_align_t);
+static const bool allocation_counter_installed = (AllocationCounter::installed = true);
+
+void* operator new(size_t size) {
+    void* block = malloc(size + allocation_header);
+    if(block == nullptr) {
+        throw bad_alloc();
+    }
+    *(size_t*)block = size;
+    AllocationCounter::count++;
+    AllocationCounter::live += size;
+    return (char*)block + allocation_header;
 }
 
-string get_best_data_structure(vector<string> data_structure, vector<vector<int>> time_taken, vector<string> api) {
-    string best_data_structure;
+void operator delete(void* p) noexcept {
+    if(p == nullptr) {
+        return;
+    }
+    void* block = (void*)((uintptr_t)p - allocation_header); // Integer arithmetic, since the header lies outside the object
+    AllocationCounter::live -= *(size_t*)block;
+    free(block);
+}
 
-    int min_avg_time = INT_MAX;
+// The sized form the compiler calls when it knows the size; the header already records it
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
 
-    for(int i = 0; i < data_structure.size(); i++) {
-        string ds = data_structure[i];
-        vector<int> tt = time_taken[i];
+// Runs the concurrent benchmark mode for every candidate up to a given thread count and returns the best one at that count
+string get_best_data_structure_at_threads(vector<string> data_structure, vector<string> api, int threads, long long ops_per_thread) {
+    string best_data_structure;
+    long long max_throughput = -1;
 
-        int avg_time = accumulate(tt.begin(), tt.end(), 0) / tt.size();
+    for(auto ds : data_structure) {
+        if(ds == "graphs") {
+            continue; // Graphs have no concurrent workload yet
+        }
+        vector<ConcurrentResult> curve = get_scaling_curve(ds, api, threads, ops_per_thread);
+        print_scaling_curve(curve);
 
-        if(avg_time <= min_avg_time) {
+        if(curve.back().ops_per_second > max_throughput) {
             best_data_structure = ds;
-            min_avg_time = avg_time;
+            max_throughput = curve.back().ops_per_second;
         }
     }
 
     return best_data_structure;
 }
 
-int main() {
-    int i = 0;
-    std::cout << "Define an API that requires fast insert(), delete(), search(), size(), and sort() operations. " << endl;
+// Reads the whole number after a command-line flag, throwing invalid_argument unless it lies between 0 and largest
+long long parse_count_flag(const string& flag, const string& text, long long largest) {
+    size_t used = 0;
+    long long value = -1;
+    try {
+        value = stoll(text, &used);
+    }
+    catch(const exception&) {
+        used = 0;
+    }
+    if(used == 0 || used != text.size() || value < 0 || value > largest) {
+        throw invalid_argument(flag + " expects a whole number from 0 to " + to_string(largest) + ", got \"" + text + "\"");
+    }
+    return value;
+}
+
+// Reads the number between 0 and 1 after a command-line flag, throwing invalid_argument if it is anything else
+double parse_fraction_flag(const string& flag, const string& text) {
+    size_t used = 0;
+    double value = -1;
+    try {
+        value = stod(text, &used);
+    }
+    catch(const exception&) {
+        used = 0;
+    }
+    if(used == 0 || used != text.size() || !(value >= 0 && value <= 1)) {
+        throw invalid_argument(flag + " expects a number from 0 to 1, got \"" + text + "\"");
+    }
+    return value;
+}
+
+int main(int argc, char* argv[]) {
+    int threads = 0; // The thread count for the concurrent benchmark mode (--threads N), or 0 to skip it
+    string spec_path; // A requirement spec file describing the workload (--spec FILE), or empty to ask for a size
+    RankingWeights weights; // How much latency, slowest-trial latency, throughput, memory and allocations count (--weights L,W,Q,M,A)
+    bool race = true; // Whether to drop clearly beaten candidates on small inputs before the full benchmark (off with --no-race)
+    string train_path; // Where to write a recommender trained offline (--train FILE), or empty to run a query
+    int samples = 200; // The number of random workloads to train on (--samples N)
+    string train_sizes = "64..4096"; // The range of workload sizes to train on (--train-sizes MIN..MAX)
+    string model_path; // A trained recommender to answer from before measuring (--model FILE), or empty to always measure
+    double min_confidence = 0.6; // The confidence below which the recommender's answer is checked by measuring (--confidence X)
+    bool tune = false; // Whether to tune the parameters of the recommended data structure for the workload (--tune)
+    string serve_path; // A Unix socket to answer recommendation requests on until stopped (--serve PATH)
+    string query_path; // A running server to send the specs on standard input to, one per line (--query PATH)
+    int workers = 0; // The server's or batch's worker threads (--workers N), or 0 for one per core
+    string specs_path; // A file of workload specs to recommend for in one run (--specs FILE)
+    string out_path; // Where the batch writes its records (--out FILE), or empty for standard output
+    int batch = 16; // The most requests a server worker takes at once (--batch N)
+    string bench_name; // A dedicated benchmark of the concurrent containers or graph engines to run (--bench NAME), or "all"
+    BenchSettings bench_settings; // Its size (--size N) and graph generator (--graph MODEL); its threads come from --threads
+    // Read the flags, stopping with a message at the first value that is not a valid number or weight list
+    try {
+        for(int a = 1; a < argc; a++) {
+            if(string(argv[a]) == "--no-race") {
+                race = false;
+            }
+            if(string(argv[a]) == "--tune") {
+                tune = true;
+            }
+            if(a + 1 == argc) {
+                break;
+            }
+            if(string(argv[a]) == "--threads") {
+                threads = (int)parse_count_flag("--threads", argv[a + 1], INT_MAX);
+            }
+            if(string(argv[a]) == "--spec") {
+                spec_path = argv[a + 1];
+            }
+            if(string(argv[a]) == "--serve") {
+                serve_path = argv[a + 1];
+            }
+            if(string(argv[a]) == "--query") {
+                query_path = argv[a + 1];
+            }
+            if(string(argv[a]) == "--specs") {
+                specs_path = argv[a + 1];
+            }
+            if(string(argv[a]) == "--out") {
+                out_path = argv[a + 1];
+            }
+            if(string(argv[a]) == "--workers") {
+                workers = (int)parse_count_flag("--workers", argv[a + 1], INT_MAX);
+            }
+            if(string(argv[a]) == "--batch") {
+                batch = (int)parse_count_flag("--batch", argv[a + 1], INT_MAX);
+            }
+            if(string(argv[a]) == "--bench") {
+                bench_name = argv[a + 1];
+            }
+            if(string(argv[a]) == "--size") {
+                bench_settings.size = parse_count_flag("--size", argv[a + 1], INT32_MAX);
+            }
+            if(string(argv[a]) == "--graph") {
+                bench_settings.model = argv[a + 1];
+            }
+            if(string(argv[a]) == "--train") {
+                train_path = argv[a + 1];
+            }
+            if(string(argv[a]) == "--samples") {
+                samples = (int)parse_count_flag("--samples", argv[a + 1], INT_MAX);
+            }
+            if(string(argv[a]) == "--train-sizes") {
+                train_sizes = argv[a + 1];
+            }
+            if(string(argv[a]) == "--model") {
+                model_path = argv[a + 1];
+            }
+            if(string(argv[a]) == "--confidence") {
+                min_confidence = parse_fraction_flag("--confidence", argv[a + 1]);
+            }
+            if(string(argv[a]) == "--weights") {
+                weights = parse_ranking_weights(argv[a + 1]);
+            }
+        }
+    }
+    catch(const invalid_argument& e) {
+        std::cout << e.what() << endl;
+        return 1;
+    }
+
+    if(!bench_name.empty()) {
+        // Run the dedicated benchmarks that the recommendation does not cover
+        bench_settings.threads = threads;
+        try {
+            run_bench(bench_name, bench_settings, std::cout);
+        }
+        catch(const invalid_argument& e) {
+            std::cout << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if(!train_path.empty()) {
+        // Offline training: sweep random workloads and save the fitted recommender for later queries
+        DecisionTreeRecommender model;
+        try {
+            WorkloadProfile sizes;
+            parse_size_range(trim_lower(train_sizes), sizes);
+            model = train_recommender(samples, 1, sizes.minSize, sizes.maxSize, &std::cout);
+        }
+        catch(const invalid_argument& e) {
+            std::cout << "Cannot train the recommender: " << e.what() << endl;
+            return 1;
+        }
+        model.save(train_path);
+        std::cout << "Saved the recommender to " << train_path << endl;
+        return 0;
+    }
+
+    if(!specs_path.empty()) {
+        // Batch mode: recommend for every spec in the file, sharing the benchmarks they have in common
+        ifstream specs_file(specs_path);
+        if(!specs_file) {
+            std::cout << "Cannot open the spec file " << specs_path << endl;
+            return 1;
+        }
+        stringstream text;
+        text << specs_file.rdbuf();
+        vector<string> specs = split_spec_file(text.str());
+        int units_run = 0;
+        int units_requested = 0;
+        auto start = chrono::high_resolution_clock::now();
+        vector<BatchRecord> records = run_batch(specs, workers > 0 ? workers : max(1, (int)thread::hardware_concurrency()), 5, units_run, units_requested);
+        auto stop = chrono::high_resolution_clock::now();
+        if(out_path.empty()) {
+            write_batch_records(std::cout, records);
+        }
+        else {
+            ofstream out(out_path);
+            if(!out) {
+                std::cout << "Cannot write " << out_path << endl;
+                return 1;
+            }
+            write_batch_records(out, records);
+        }
+        std::cerr << specs.size() << " specs, " << units_run << " benchmarks run for " << units_requested << " requested, in "
+                  << chrono::duration_cast<chrono::milliseconds>(stop - start).count() << " ms" << endl;
+        return 0;
+    }
+
+    if(!serve_path.empty() || !query_path.empty()) {
+#ifdef _WIN32
+        std::cout << "The recommendation service needs Unix domain sockets" << endl;
+        return 1;
+#else
+        try {
+            if(!query_path.empty()) {
+                // Send each spec line on standard input to the running server and print its answers
+                vector<string> specs;
+                string line;
+                while(getline(std::cin, line)) {
+                    specs.push_back(line);
+                }
+                for(const string& reply : RecommendationServer::query(query_path, specs)) {
+                    std::cout << reply << endl;
+                }
+                return 0;
+            }
+            RecommendationServer server(serve_path, workers, batch);
+            if(!model_path.empty()) {
+                server.loadModel(model_path, min_confidence);
+            }
+            std::cout << "Serving recommendations on " << serve_path << endl;
+            server.runUntilSignalled();
+            std::cout << server.statistics() << endl;
+        }
+        catch(const runtime_error& e) {
+            std::cout << e.what() << endl;
+            return 1;
+        }
+        return 0;
+#endif
+    }
 
     vector<string> api = {"insert()", "delete()", "search()", "size()", "sort()"};
-    vector<string> data_structure = {"array", "stack", "queue", "linked list", "hash table", "BST"};
+    vector<string> data_structure = all_data_structures();
+    vector<double> frequencies(api.size(), 1.0 / api.size()); // How often the workload calls each method
 
-    
     vector<string> data;
-    int size_data;
-    std::cout << "What is the size of data: " << endl;
-    std::cin >> size_data;
-    for(size_t i = 0; i < size_data; i++) {
-        data.push_back("i");
+    long long size_data = 0;
+    WorkloadProfile profile; // The workload the recommender is asked about
+    profile.operations = api;
+    profile.frequencies = frequencies;
+    if(!spec_path.empty()) {
+        ifstream spec_file(spec_path);
+        if(!spec_file) {
+            std::cout << "Cannot open the spec file " << spec_path << endl;
+            return 1;
+        }
+        stringstream spec;
+        spec << spec_file.rdbuf();
+        try {
+            profile = parse_requirements(spec.str());
+        }
+        catch(const invalid_argument& e) {
+            std::cout << "Bad spec: " << e.what() << endl;
+            return 1;
+        }
+        api = profile.operations;
+        frequencies = profile.frequencies;
+        data_structure = filter_candidates(profile);
+        data = generate_workload_data(profile);
+        size_data = profile.maxSize;
+        if(threads == 0 && profile.threads > 1) {
+            threads = profile.threads;
+        }
+
+        std::cout << "The spec asks for:";
+        for(size_t j = 0; j < api.size(); j++) {
+            std::cout << " " << api[j] << " " << (int)(frequencies[j] * 100 + 0.5) << "%";
+        }
+        std::cout << " on " << size_data << " " << profile.keyType << " keys" << endl;
+        if(data_structure.empty()) {
+            std::cout << "No data structure meets every requirement of the spec" << endl;
+            return 1;
+        }
+        for(auto ds : data_structure) {
+            ContainerInfo info = RegisteredContainers::entries[RegisteredContainers::indexOf(ds.c_str())];
+            std::cout << "  candidate " << ds << ": insert " << complexity_name(info.insertCost) << ", delete " << complexity_name(info.deleteCost)
+                      << ", search " << complexity_name(info.searchCost) << endl;
+        }
     }
+    else {
+        std::cout << "Define an API that requires fast insert(), delete(), search(), size(), and sort() operations. " << endl;
 
-    vector<vector<int>> time_taken = get_full_time_taken(data_structure, api, data);
-    string bset = get_best_data_structure(data_structure, time_taken, api);
-    for(vector<int> time : time_taken){
+        std::cout << "What is the size of data: " << endl;
+        std::cin >> size_data;
+        if(!std::cin || size_data < 1) {
+            std::cout << "The size of data must be a positive number" << endl;
+            return 1;
+        }
+        for(long long i = 0; i < size_data; i++) {
+            data.push_back("i" + to_string(i)); // Distinct values, so search() has to scan instead of matching the first element
+        }
+        profile.minSize = profile.maxSize = size_data;
+    }
+
+    if(!model_path.empty()) {
+        // Answer from the trained recommender when it is confident, and measure only when it is not
+        vector<pair<string,double>> ranking;
+        bool covered = false;
+        try {
+            DecisionTreeRecommender model = DecisionTreeRecommender::load(model_path);
+            covered = model.coversSize(profile_features(profile));
+            ranking = model.rank(profile_features(profile), data_structure);
+        }
+        catch(const runtime_error& e) {
+            std::cout << e.what() << endl;
+            return 1;
+        }
+        for(const pair<string,double>& r : ranking) {
+            std::cout << "  predicted " << r.first << ": confidence " << r.second << endl;
+        }
+        if(!ranking.empty() && ranking[0].second >= min_confidence && threads == 0) {
+            std::cout << "The best data structure is : " << ranking[0].first << endl;
+            if(tune) {
+                print_tuning(tune_data_structure(ranking[0].first, api, data, frequencies));
+            }
+            return 0;
+        }
+        if(!covered) {
+            std::cout << "The recommender was not trained on workloads of this size, so measuring" << endl;
+        }
+        else {
+            std::cout << "The recommender is not confident enough, so measuring" << endl;
+        }
+    }
+
+    // Race the candidates so the clearly beaten ones are dropped on small inputs, then rank the rest on every objective
+    vector<CandidateMeasurement> measurements;
+    if(race) {
+        RaceResult result = race_candidates(data_structure, api, data, frequencies);
+        print_race(result);
+        measurements = result.finalists;
+        data_structure.clear();
+        for(const CandidateMeasurement& m : measurements) {
+            data_structure.push_back(m.data_structure);
+        }
+    }
+    else {
+        measurements = measure_candidates(data_structure, api, data, frequencies);
+    }
+
+    // Print the times the measurement already took, rather than running every candidate once more
+    for(const CandidateMeasurement& m : measurements){
         std::cout << "[" ;
-        for(int t : time) {
+        for(int t : m.method_times) {
             std::cout << t << " ";
         }
-        std::cout << "]" << " time taken by " << data_structure.at(i) <<  " for each method" << endl;
-        i++;
+        std::cout << "]" << " time taken by " << m.data_structure <<  " for each method" << endl;
     }
     std::cout << endl;
 
-    std::cout << "The best data structure is : " << bset << endl;
+    // The starred candidates are the Pareto front, the tradeoffs worth choosing between
+    print_ranking(measurements, weights);
+    std::cout << endl;
+
+    string best = get_pareto_best_data_structure(measurements, weights);
+    std::cout << "The best data structure is : " << best << endl;
+    if(tune) {
+        print_tuning(tune_data_structure(best, api, data, frequencies));
+    }
+
+    if(threads > 0) {
+        std::cout << endl;
+        string best_at_threads = get_best_data_structure_at_threads(data_structure, api, threads, size_data);
+        std::cout << "The best data structure at " << threads << " threads is : " << best_at_threads << endl;
+    }
 
 }
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+using namespace std;
+
+// A class for a read-only view of a whole file. On POSIX systems the file is memory-mapped, so the pages are read
+// on demand straight from the page cache with no copy; elsewhere the file is read into a buffer once.
+class MappedFile {
+    private:
+        const char* begin; // The first byte of the file, or nullptr for an empty file
+        size_t length; // The number of bytes in the file
+#ifdef _WIN32
+        vector<char> buffer; // The file contents, read in one go
+#else
+        void* mapping; // The address returned by mmap, or nullptr if nothing was mapped
+#endif
+
+    public:
+        // A constructor that opens a file and maps it, throwing runtime_error if it cannot be read
+        MappedFile(const string& path) {
+            begin = nullptr;
+            length = 0;
+#ifdef _WIN32
+            ifstream in(path, ios::binary | ios::ate);
+            if (!in) {
+                throw runtime_error("Cannot open " + path);
+            }
+            length = (size_t)in.tellg();
+            buffer.resize(length);
+            in.seekg(0);
+            in.read(buffer.data(), length);
+            begin = buffer.data();
+#else
+            mapping = nullptr;
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw runtime_error("Cannot open " + path);
+            }
+            struct stat info;
+            if (fstat(fd, &info) != 0) {
+                close(fd);
+                throw runtime_error("Cannot stat " + path);
+            }
+            length = (size_t)info.st_size;
+            if (length > 0) { // mmap rejects a zero length, and an empty file needs no mapping
+                mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapping == MAP_FAILED) {
+                    mapping = nullptr;
+                    close(fd);
+                    throw runtime_error("Cannot map " + path);
+                }
+                madvise(mapping, length, MADV_SEQUENTIAL); // Loaders read front to back, so let the kernel read ahead
+                begin = (const char*)mapping;
+            }
+            close(fd); // The mapping keeps the file alive on its own
+#endif
+        }
+
+        // A destructor that unmaps the file
+        ~MappedFile() {
+#ifndef _WIN32
+            if (mapping != nullptr) {
+                munmap(mapping, length);
+            }
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete; // A copy would unmap the same pages twice
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // A method that returns the first byte of the file
+        const char* data() const {
+            return begin;
+        }
+
+        // A method that returns the number of bytes in the file
+        size_t size() const {
+            return length;
+        }
+};
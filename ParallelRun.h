@@ -0,0 +1,20 @@
+#pragma once
+#include <vector>
+#include <thread>
+using namespace std;
+
+// A helper function that runs fn(0), fn(1), ..., fn(threads - 1) on that many threads and waits for all of them
+template <class Function>
+void run_parallel(int threads, Function fn) {
+    if (threads <= 1) { // No need to start a thread for a single chunk
+        fn(0);
+        return;
+    }
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(thread(fn, t));
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
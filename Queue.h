@@ -1,7 +1,10 @@
+#pragma once
 #include <iostream>
 #include <vector>
 #include <string>
 #include <chrono>
+#include "SimdSearch.h"
+#include "ContainerTraits.h"
 
 using namespace std;
 
@@ -15,6 +18,7 @@ class DynamicQueue {
         vector<T> data; // The underlying vector to store the elements
         int size; // The current number of elements in the queue
         int capacity; // The maximum number of elements the queue can hold
+        GrowthPolicy growth; // The capacity the queue starts with and how it grows when full
         int front; // The index of the front element in the queue
         int rear; // The index of the rear element in the queue
 
@@ -22,7 +26,7 @@ class DynamicQueue {
         // A default constructor that creates an empty queue
         DynamicQueue() {
             size = 0;
-            capacity = 10;
+            capacity = growth.initialCapacity;
             data.resize(capacity); // Allocate memory for the vector
             front = 0;
             rear = -1;
@@ -37,10 +41,21 @@ class DynamicQueue {
             rear = -1;
         }
 
+        // A constructor that creates an empty queue that starts at and grows by a given policy
+        DynamicQueue(GrowthPolicy policy) {
+            size = 0;
+            growth = policy;
+            capacity = max(1, growth.initialCapacity);
+            data.resize(capacity); // Allocate memory for the vector
+            front = 0;
+            rear = -1;
+        }
+
         // A copy constructor that creates a deep copy of another queue
         DynamicQueue(const DynamicQueue<T>& other) {
             size = other.size;
             capacity = other.capacity;
+            growth = other.growth;
             data.resize(capacity); // Allocate memory for the vector
             front = other.front;
             rear = other.rear;
@@ -59,6 +74,7 @@ class DynamicQueue {
             if (this != &other) { // Avoid self-assignment
                 size = other.size;
                 capacity = other.capacity;
+                growth = other.growth;
                 data.resize(capacity); // Allocate memory for the vector
                 front = other.front;
                 rear = other.rear;
@@ -92,7 +108,7 @@ class DynamicQueue {
         // A method that adds a new element at the rear of the queue, resizing it if necessary
         void enqueue(T val) {
             if (size == capacity) { // Check if the queue is full
-                capacity *= 2; // Double the capacity
+                capacity = growth.grow(capacity); // Grow the capacity by the growth factor
                 vector<T> temp(capacity); // Create a temporary vector with the new capacity
                 for (int i = 0; i < size; i++) {
                     temp[i] = data[(front + i) % size]; // Copy each element from the old vector to the new one using modular arithmetic 
@@ -129,15 +145,15 @@ class DynamicQueue {
             }
         }
 
-        // A method to search for an element in the queue using linear search
+        // A method to search for an element in the queue using linear search, vectorized for integral types
         int search(T element) {
-            for (int i = 0; i < size; i++) { // loop through the queue elements from front to rear in a circular way
-                int index = (front + i) % capacity; // calculate the actual index in the vector
-                if (data[index] == element) { // if the current element is equal to the target element, return its index
-                    return index;
-                }
+            int firstPart = min(size, capacity - front); // The elements from front up to the end of the vector
+            int index = find_element(data, front, firstPart, element); // Scan the first contiguous part
+            if (index != -1) {
+                return front + index; // Return the actual index in the vector
             }
-            return -1; // if the element is not found, return -1
+            index = find_element(data, 0, size - firstPart, element); // Scan the part that wrapped around to the start
+            return index; // The actual index in the vector, or -1 if the element is not found
         }
 
         // A method to sort the queue elements in ascending order using selection sort
@@ -191,7 +207,7 @@ class DynamicQueue {
                     
                 }
                 else if(method == "search()") {
-                    search(data.back());
+                    benchmark_sink = search(data.back()); // Keep the result so the scan is not optimized away
                 }
                 else if(method == "size()") {
                     int x = getSize();
@@ -209,3 +225,30 @@ class DynamicQueue {
             return time_for_ds;
         }
 };
+
+// The capabilities and costs the search engine matches workloads against
+template <class T>
+struct container_traits<DynamicQueue<T>> {
+    static constexpr const char* name = "queue";
+    static constexpr unsigned capabilities = Elements | InsertionOrder | FifoOrder | Iteration;
+    // Deleting dequeues the oldest element
+    static constexpr Complexity insertCost = Complexity::Constant;
+    static constexpr Complexity deleteCost = Complexity::Constant;
+    static constexpr Complexity searchCost = Complexity::Linear;
+
+    static constexpr double bytesPerElement(double elementBytes) {
+        return elementBytes * 1.5;
+    }
+
+    static DynamicQueue<T> make(size_t) {
+        return DynamicQueue<T>();
+    }
+
+    static vector<TuningParameter> tuningSpace(size_t n) {
+        return growth_tuning_space(n);
+    }
+
+    static DynamicQueue<T> make(size_t, const vector<double>& setting) {
+        return DynamicQueue<T>(growth_policy(setting));
+    }
+};
@@ -0,0 +1,251 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include "ContainerRegistry.h"
+#include "ConcurrentBenchmark.h"
+using namespace std;
+
+// The ranking stage turns benchmark runs into several objectives per candidate (median and slowest latency, throughput,
+// memory per element and allocations per element) and keeps the Pareto-optimal set: the candidates no other candidate
+// beats on every objective at once. Each one on the front is a different tradeoff, such as a hash table that is fast
+// but large against a sorted array that is slower but compact. A weighted utility score picks one of them automatically.
+
+// Counters for the heap allocations of the calling thread. They only move when the program replaces the global operator
+// new and delete to update them, as Main.cpp does, and sets installed; otherwise memory comes from the container traits.
+// Each thread counts its own allocations, so candidates measured in parallel do not see each other's.
+struct AllocationCounter {
+    static inline thread_local long long count = 0; // The number of allocations this thread has made
+    static inline thread_local long long live = 0; // The bytes this thread has allocated and not freed
+    static inline bool installed = false; // Whether operator new and delete update the counters
+};
+
+// The objectives measured for one candidate
+struct CandidateMeasurement {
+    string data_structure; // The name of the container, as its traits register it
+    double p50_latency; // The median time of one weighted run of the workload over the trials, in microseconds
+    double max_latency; // The slowest trial's weighted run, in microseconds; with a handful of trials this is the tail
+    double throughput; // Data items processed per second by the weighted workload
+    double bytes_per_element; // The bytes the container holds per element after the workload
+    double allocations_per_element; // The heap allocations per element during one run, or 0 if they are not counted
+    vector<double> latencies; // The time of each trial's weighted run, in microseconds
+    vector<int> method_times; // The median microseconds of each API method over the trials
+};
+
+// How much each objective counts in the utility score; only the ratios matter
+struct RankingWeights {
+    double latency = 1; // The median latency
+    double worst = 1; // The slowest trial's latency
+    double throughput = 1;
+    double memory = 1; // The bytes per element
+    double allocations = 1; // The allocations per element
+};
+
+// A function that reads ranking weights from a comma-separated list in the order latency,worst,throughput,memory,allocations,
+// throwing invalid_argument if an entry is not a non-negative number
+inline RankingWeights parse_ranking_weights(const string& text) {
+    vector<double> values;
+    stringstream in(text);
+    string item;
+    while (getline(in, item, ',')) {
+        size_t used = 0;
+        double value = -1;
+        try {
+            value = stod(item, &used);
+        }
+        catch (const exception&) {
+            used = 0;
+        }
+        if (used == 0 || value < 0) {
+            throw invalid_argument("Bad ranking weight \"" + item + "\"");
+        }
+        values.push_back(value);
+    }
+    if (values.size() != 5) {
+        throw invalid_argument("Expected 5 ranking weights (latency,worst,throughput,memory,allocations)");
+    }
+    RankingWeights weights;
+    weights.latency = values[0];
+    weights.worst = values[1];
+    weights.throughput = values[2];
+    weights.memory = values[3];
+    weights.allocations = values[4];
+    return weights;
+}
+
+// The raw results of running one container over a number of trials, before they are weighted by a workload's mix
+struct TrialResults {
+    string data_structure; // The name of the container
+    vector<vector<int>> times; // The microseconds of each API method in each trial
+    size_t elements = 0; // The number of data items each trial ran over
+    double bytes_per_element = 0; // The bytes the container held per element after a trial
+    double allocations_per_element = 0; // The heap allocations per element during a trial, or 0 if they are not counted
+};
+
+// A function that runs a named candidate over a number of trials, each on a fresh container made by its traits
+inline TrialResults run_trials(const string& ds, const vector<string>& api, const vector<string>& data, int trials) {
+    TrialResults result;
+    result.data_structure = ds;
+    result.elements = data.size();
+    RegisteredContainers::forEach([&](auto tag) {
+        using Container = typename decltype(tag)::type;
+        using Traits = container_traits<Container>;
+        if (ds != Traits::name) {
+            return;
+        }
+        long long allocations = 0;
+        long long liveBytes = 0;
+        for (int t = 0; t < max(1, trials); t++) {
+            long long liveBefore = AllocationCounter::live;
+            long long countBefore = AllocationCounter::count;
+            Container container = Traits::make(data.size());
+            result.times.push_back(time_workload(container, api, data));
+            allocations += AllocationCounter::count - countBefore;
+            liveBytes += AllocationCounter::live - liveBefore; // The container is still alive, so this is what it holds
+        }
+        double n = max((size_t)1, data.size());
+        if (AllocationCounter::installed) {
+            result.bytes_per_element = (double)liveBytes / result.times.size() / n;
+            result.allocations_per_element = (double)allocations / result.times.size() / n;
+        }
+        else {
+            result.bytes_per_element = Traits::bytesPerElement(sizeof(string));
+        }
+    });
+    return result;
+}
+
+// A function that weights the trials of a candidate by a workload's mix and summarizes them as a measurement. A run's
+// latency is the sum of the method times weighted by how often the workload calls each method. The benchmark times whole
+// methods in whole microseconds over a handful of trials, so the summary is the median and the slowest trial rather
+// than percentiles it cannot resolve.
+inline CandidateMeasurement summarize_trials(const TrialResults& trials, const vector<double>& frequencies) {
+    CandidateMeasurement m;
+    m.data_structure = trials.data_structure;
+    double total = 0;
+    for (const vector<int>& times : trials.times) {
+        double weighted = 0;
+        for (size_t j = 0; j < times.size() && j < frequencies.size(); j++) {
+            weighted += frequencies[j] * times[j];
+        }
+        m.latencies.push_back(weighted);
+        total += weighted;
+    }
+    for (size_t j = 0; !trials.times.empty() && j < trials.times[0].size(); j++) {
+        vector<int> method;
+        for (const vector<int>& times : trials.times) {
+            method.push_back(times[j]);
+        }
+        nth_element(method.begin(), method.begin() + (method.size() - 1) / 2, method.end());
+        m.method_times.push_back(method[(method.size() - 1) / 2]);
+    }
+    vector<double> sorted = m.latencies;
+    sort(sorted.begin(), sorted.end());
+    double n = max((size_t)1, trials.elements);
+    double mean = sorted.empty() ? 0 : total / sorted.size();
+    m.p50_latency = sorted.empty() ? 0 : sorted[(sorted.size() - 1) / 2];
+    m.max_latency = sorted.empty() ? 0 : sorted.back();
+    m.throughput = mean > 0 ? n * 1e6 / mean : n * 1e6; // A run too fast to time counts as one microsecond
+    m.bytes_per_element = trials.bytes_per_element;
+    m.allocations_per_element = trials.allocations_per_element;
+    return m;
+}
+
+// A function that measures every named candidate over a number of trials and weights them by the workload's mix
+inline vector<CandidateMeasurement> measure_candidates(const vector<string>& data_structures, const vector<string>& api,
+                                                       const vector<string>& data, const vector<double>& frequencies, int trials = 5) {
+    vector<CandidateMeasurement> measurements;
+    for (const string& ds : data_structures) {
+        if (RegisteredContainers::indexOf(ds.c_str()) >= 0) {
+            measurements.push_back(summarize_trials(run_trials(ds, api, data, trials), frequencies));
+        }
+    }
+    return measurements;
+}
+
+// A function that checks if one measurement is at least as good as another on every objective and better on at least one
+inline bool dominates(const CandidateMeasurement& a, const CandidateMeasurement& b) {
+    bool noWorse = a.p50_latency <= b.p50_latency && a.max_latency <= b.max_latency && a.throughput >= b.throughput
+                && a.bytes_per_element <= b.bytes_per_element && a.allocations_per_element <= b.allocations_per_element;
+    bool better = a.p50_latency < b.p50_latency || a.max_latency < b.max_latency || a.throughput > b.throughput
+               || a.bytes_per_element < b.bytes_per_element || a.allocations_per_element < b.allocations_per_element;
+    return noWorse && better;
+}
+
+// A function that returns the indexes of the Pareto-optimal measurements, those no other measurement dominates
+inline vector<int> pareto_front(const vector<CandidateMeasurement>& measurements) {
+    vector<int> front;
+    for (size_t i = 0; i < measurements.size(); i++) {
+        bool dominated = false;
+        for (size_t j = 0; j < measurements.size() && !dominated; j++) {
+            dominated = j != i && dominates(measurements[j], measurements[i]);
+        }
+        if (!dominated) {
+            front.push_back((int)i);
+        }
+    }
+    return front;
+}
+
+// A function that scores each measurement between 0 and 1: every objective is scaled so the best candidate gets 1 and the
+// worst 0, and the scaled objectives are averaged with the given weights. An objective on which all candidates tie adds 1.
+inline vector<double> utility_scores(const vector<CandidateMeasurement>& measurements, const RankingWeights& weights) {
+    size_t count = measurements.size();
+    vector<double> scores(count, 0);
+    double totalWeight = weights.latency + weights.worst + weights.throughput + weights.memory + weights.allocations;
+    if (count == 0 || totalWeight <= 0) {
+        return scores;
+    }
+    // Adds one objective to the scores, where lowerIsBetter says which way it points
+    auto addObjective = [&](double weight, bool lowerIsBetter, auto value) {
+        double lo = value(measurements[0]);
+        double hi = lo;
+        for (const CandidateMeasurement& m : measurements) {
+            lo = min(lo, value(m));
+            hi = max(hi, value(m));
+        }
+        for (size_t i = 0; i < count; i++) {
+            double scaled = hi > lo ? (value(measurements[i]) - lo) / (hi - lo) : 1;
+            if (hi > lo && lowerIsBetter) {
+                scaled = 1 - scaled;
+            }
+            scores[i] += weight * scaled / totalWeight;
+        }
+    };
+    addObjective(weights.latency, true, [](const CandidateMeasurement& m) { return m.p50_latency; });
+    addObjective(weights.worst, true, [](const CandidateMeasurement& m) { return m.max_latency; });
+    addObjective(weights.throughput, false, [](const CandidateMeasurement& m) { return m.throughput; });
+    addObjective(weights.memory, true, [](const CandidateMeasurement& m) { return m.bytes_per_element; });
+    addObjective(weights.allocations, true, [](const CandidateMeasurement& m) { return m.allocations_per_element; });
+    return scores;
+}
+
+// A function that picks the candidate on the Pareto front with the highest utility score, or "" if there are none
+inline string get_pareto_best_data_structure(const vector<CandidateMeasurement>& measurements, const RankingWeights& weights) {
+    vector<double> scores = utility_scores(measurements, weights);
+    string best;
+    double bestScore = -1;
+    for (int i : pareto_front(measurements)) { // A dominated candidate can never score higher than the one dominating it
+        if (scores[i] > bestScore) {
+            best = measurements[i].data_structure;
+            bestScore = scores[i];
+        }
+    }
+    return best;
+}
+
+// A function that prints every measurement with its utility score, marking the ones on the Pareto front
+inline void print_ranking(const vector<CandidateMeasurement>& measurements, const RankingWeights& weights) {
+    vector<double> scores = utility_scores(measurements, weights);
+    vector<int> front = pareto_front(measurements);
+    for (size_t i = 0; i < measurements.size(); i++) {
+        const CandidateMeasurement& m = measurements[i];
+        bool onFront = find(front.begin(), front.end(), (int)i) != front.end();
+        cout << (onFront ? "* " : "  ") << m.data_structure << ": p50 " << m.p50_latency << " us, max " << m.max_latency
+             << " us, " << (long long)m.throughput << " items/s, " << m.bytes_per_element << " bytes/element, "
+             << m.allocations_per_element << " allocations/element, utility " << scores[i] << endl;
+    }
+}
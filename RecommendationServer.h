@@ -0,0 +1,530 @@
+#pragma once
+#ifndef _WIN32
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <deque>
+#include <list>
+#include <map>
+#include <random>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "ContainerRegistry.h"
+#include "RequirementParser.h"
+#include "Ranking.h"
+#include "BenchmarkRace.h"
+#include "Recommender.h"
+using namespace std;
+
+// A long-running recommendation service on a Unix domain socket, so tools that ask many questions pay for process
+// startup and benchmarks once instead of on every query. The protocol is line based: each request is a requirement
+// spec on one line, with its requirements separated by semicolons as in "operations: insert 40%, search 60%; size: 10k",
+// and each answer is one line prefixed with the request's number on its connection, because answers to pipelined
+// requests may come back out of order:
+//
+//     #0 ok queue model 0.8 candidates=queue,linked list 120us
+//     #1 error Unknown requirement "colour" in "colour: red" 35us
+//
+// The request "stats" answers with the request count, cache hits, batches and latency percentiles, the percentiles
+// taken over a bounded random sample of the requests.
+//
+// A pool of worker threads takes requests off a queue. A worker takes the oldest request together with the queued
+// requests for the same workload, so they share one answer, while requests for other workloads stay queued for the
+// other workers instead of waiting behind a measurement. Answers are also kept by workload, up to a fixed number with
+// the least recently used dropped first, and a request for a workload still being measured waits for that result
+// instead of measuring again. The trained recommender answers when it is confident. Otherwise the candidates are raced,
+// one measurement at a time, because concurrent benchmarks would slow each other down and skew the results. A workload
+// larger than the server's size limit, or a request line longer than its line limit, is answered with an error.
+
+// The flags for sending on a socket without raising SIGPIPE when the peer has gone. Systems without MSG_NOSIGNAL,
+// such as macOS, set SO_NOSIGPIPE on each socket instead.
+#ifdef MSG_NOSIGNAL
+inline const int server_send_flags = MSG_NOSIGNAL;
+#else
+inline const int server_send_flags = 0;
+#endif
+
+// The answer to one workload
+struct Recommendation {
+    string best; // The recommended container
+    string source; // "model" if the recommender answered, "measured" if the candidates were raced
+    double confidence; // The recommender's confidence, or 1 for a measurement
+    vector<string> candidates; // Every container that meets the workload's requirements
+};
+
+class RecommendationServer {
+    private:
+        // A client connection, closed once the reader and every pending answer are done with it
+        struct Connection {
+            int fd;
+            mutex writeMutex; // Keeps answers from different workers from interleaving
+
+            Connection(int socket) {
+                fd = socket;
+#ifdef SO_NOSIGPIPE
+                int on = 1;
+                setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+            }
+
+            ~Connection() {
+                close(fd);
+            }
+        };
+
+        // A request waiting for a worker
+        struct Request {
+            shared_ptr<Connection> connection;
+            long long number; // The request's position on its connection
+            string spec;
+            string key; // The workload the spec asks about, or empty for "stats" and specs that do not parse
+            chrono::high_resolution_clock::time_point received;
+        };
+
+        // A cached answer, with its place in the order of use
+        struct CacheEntry {
+            shared_future<Recommendation> answer; // The workload's answer, ready or being worked out
+            list<string>::iterator use; // The workload's key in recentUse
+            long long id; // Tells this entry from a later one for the same workload
+        };
+
+        string socketPath; // Where the socket lives in the file system
+        int workerCount; // The number of threads answering requests
+        size_t batchSize; // The most requests for one workload a worker takes off the queue at once
+        int listenFd; // The listening socket, or -1 before run
+        atomic<bool> stopping; // Set to make run return
+        atomic<int> activeReaders; // The connections still being read
+
+        DecisionTreeRecommender model; // The trained recommender, if one was loaded
+        double minConfidence; // The confidence below which the recommender's answer is measured instead
+
+        mutex queueMutex;
+        condition_variable queueReady;
+        deque<Request> pending; // The requests no worker has taken yet
+
+        long long maxWorkloadSize; // The largest workload size the server generates data for
+        size_t maxLineLength; // The longest request line the server reads
+        size_t cacheCapacity; // The most workload answers kept
+
+        mutex cacheMutex;
+        map<string, CacheEntry> answers; // Each workload's answer, ready or being worked out
+        list<string> recentUse; // The keys of the cached workloads, most recently used first
+        long long nextEntryId;
+        mutex benchmarkMutex; // Lets one measurement run at a time
+
+        mutex metricsMutex;
+        vector<long long> latencySample; // A uniform random sample of the request latencies, in microseconds
+        size_t latencySampleSize; // The most latencies the sample holds
+        mt19937 sampler; // Picks which latencies the sample keeps once it is full
+        long long requests;
+        long long cacheHits;
+        long long batches;
+
+        // A helper method that returns the key two requests share when they ask about the same workload
+        static string workloadKey(const WorkloadProfile& profile) {
+            stringstream key;
+            for (size_t j = 0; j < profile.operations.size(); j++) {
+                key << profile.operations[j] << "=" << (int)(profile.frequencies[j] * 1000 + 0.5) << ",";
+            }
+            key << profile.maxSize << "," << profile.keyType << "," << required_capabilities(profile) << "," << profile.constantInsert
+                << profile.constantDelete << "," << profile.memoryBudget;
+            return key.str();
+        }
+
+        // A helper method that works out the answer for a workload, from the recommender if it is confident
+        Recommendation recommend(const WorkloadProfile& profile) {
+            Recommendation result;
+            result.candidates = filter_candidates(profile);
+            if (result.candidates.empty()) {
+                throw invalid_argument("No data structure meets every requirement of the spec");
+            }
+            if (model.isTrained()) {
+                vector<pair<string,double>> ranking = model.rank(profile_features(profile), result.candidates);
+                if (!ranking.empty() && ranking[0].second >= minConfidence) {
+                    result.best = ranking[0].first;
+                    result.source = "model";
+                    result.confidence = ranking[0].second;
+                    return result;
+                }
+            }
+            vector<string> data = generate_workload_data(profile);
+            lock_guard<mutex> lock(benchmarkMutex);
+            RaceResult race = race_candidates(result.candidates, profile.operations, data, profile.frequencies);
+            result.best = get_pareto_best_data_structure(race.finalists, RankingWeights());
+            result.source = "measured";
+            result.confidence = 1;
+            return result;
+        }
+
+        // A helper method that writes one line to a connection
+        static void send(Connection& connection, const string& line) {
+            lock_guard<mutex> lock(connection.writeMutex);
+            string text = line + "\n";
+            size_t sent = 0;
+            while (sent < text.size()) {
+                ssize_t n = ::send(connection.fd, text.data() + sent, text.size() - sent, server_send_flags);
+                if (n <= 0) {
+                    return; // The client went away, so there is nobody to answer
+                }
+                sent += n;
+            }
+        }
+
+        // A helper method that answers one request, sharing the answer with every other request for the same workload
+        string answer(const string& spec, bool& cached) {
+            cached = false;
+            if (trim_lower(spec) == "stats") {
+                return statistics();
+            }
+            WorkloadProfile profile = parse_requirements(spec);
+            if (profile.maxSize > maxWorkloadSize) {
+                throw invalid_argument("The size " + to_string(profile.maxSize) + " is above the server's limit of " + to_string(maxWorkloadSize));
+            }
+            string key = workloadKey(profile);
+            shared_future<Recommendation> future;
+            promise<Recommendation> work;
+            long long id = -1; // The id of the entry this request has to fill in, or -1 if another one is
+            {
+                lock_guard<mutex> lock(cacheMutex);
+                auto it = answers.find(key);
+                if (it == answers.end()) {
+                    future = work.get_future().share();
+                    recentUse.push_front(key);
+                    id = nextEntryId++;
+                    answers[key] = {future, recentUse.begin(), id};
+                    if (answers.size() > cacheCapacity) { // Waiting requests keep their own copy of an evicted answer
+                        answers.erase(recentUse.back());
+                        recentUse.pop_back();
+                    }
+                }
+                else {
+                    future = it->second.answer;
+                    recentUse.splice(recentUse.begin(), recentUse, it->second.use);
+                    cached = true;
+                }
+            }
+            if (id >= 0) {
+                try {
+                    work.set_value(recommend(profile));
+                }
+                catch (...) {
+                    work.set_exception(current_exception());
+                    lock_guard<mutex> lock(cacheMutex); // A failed workload is worked out again next time
+                    auto it = answers.find(key);
+                    if (it != answers.end() && it->second.id == id) {
+                        recentUse.erase(it->second.use);
+                        answers.erase(it);
+                    }
+                }
+            }
+            Recommendation r = future.get(); // Rethrows the error of a workload that has no answer
+            stringstream line;
+            line << "ok " << r.best << " " << r.source << " " << r.confidence;
+            line << " candidates=";
+            for (size_t i = 0; i < r.candidates.size(); i++) {
+                line << (i == 0 ? "" : ",") << r.candidates[i];
+            }
+            return line.str();
+        }
+
+        // A helper method that adds one request's latency to the counters, keeping a uniform sample of the latencies
+        // (reservoir sampling), so the memory and the cost of statistics stay bounded however long the server runs
+        void record(long long micros, bool cached) {
+            lock_guard<mutex> lock(metricsMutex);
+            requests++;
+            cacheHits += cached;
+            if (latencySample.size() < latencySampleSize) {
+                latencySample.push_back(micros);
+            }
+            else {
+                long long slot = uniform_int_distribution<long long>(0, requests - 1)(sampler);
+                if (slot < (long long)latencySampleSize) {
+                    latencySample[slot] = micros;
+                }
+            }
+        }
+
+        // A helper method that takes the oldest request and the queued requests for the same workload off the queue,
+        // answers them once, and repeats until the server stops
+        void work() {
+            while (true) {
+                vector<Request> batch;
+                {
+                    unique_lock<mutex> lock(queueMutex);
+                    queueReady.wait(lock, [this] { return stopping || !pending.empty(); });
+                    if (pending.empty()) {
+                        return;
+                    }
+                    batch.push_back(move(pending.front()));
+                    pending.pop_front();
+                    const string& key = batch[0].key;
+                    for (auto it = pending.begin(); !key.empty() && it != pending.end() && batch.size() < batchSize;) {
+                        if (it->key == key) {
+                            batch.push_back(move(*it));
+                            it = pending.erase(it);
+                        }
+                        else {
+                            ++it;
+                        }
+                    }
+                }
+                bool cached = false;
+                string body;
+                try {
+                    body = answer(batch[0].spec, cached);
+                }
+                catch (const exception& e) {
+                    body = string("error ") + e.what();
+                }
+                for (size_t i = 0; i < batch.size(); i++) {
+                    long long micros = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - batch[i].received).count();
+                    send(*batch[i].connection, "#" + to_string(batch[i].number) + " " + body + " " + to_string(micros) + "us");
+                    record(micros, cached || i > 0); // The rest of the batch reuse the first request's answer
+                }
+                lock_guard<mutex> lock(metricsMutex);
+                batches++;
+            }
+        }
+
+        // A helper method that reads the requests on one connection and queues them, one per line
+        void read(shared_ptr<Connection> connection) {
+            string buffer;
+            char chunk[4096];
+            long long number = 0;
+            while (!stopping) {
+                pollfd ready = {connection->fd, POLLIN, 0};
+                if (poll(&ready, 1, 200) <= 0) { // Wake up now and then to notice the server stopping
+                    continue;
+                }
+                ssize_t n = recv(connection->fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    return;
+                }
+                buffer.append(chunk, n);
+                size_t end;
+                while ((end = buffer.find('\n')) != string::npos) {
+                    string line = buffer.substr(0, end);
+                    buffer.erase(0, end + 1);
+                    if (trim_lower(line).empty()) {
+                        continue;
+                    }
+                    string key;
+                    try { // Parsed here only to group requests for one workload; the worker reports any error
+                        key = trim_lower(line) == "stats" ? "" : workloadKey(parse_requirements(line));
+                    }
+                    catch (const invalid_argument&) {
+                        key.clear();
+                    }
+                    {
+                        lock_guard<mutex> lock(queueMutex);
+                        pending.push_back({connection, number++, line, key, chrono::high_resolution_clock::now()});
+                    }
+                    queueReady.notify_one();
+                }
+                if (buffer.size() > maxLineLength) { // Nothing after this point could be framed, so hang up
+                    send(*connection, "#" + to_string(number) + " error The request is longer than " + to_string(maxLineLength) + " bytes");
+                    return;
+                }
+            }
+        }
+
+    public:
+        // A constructor that sets up a server on a given socket path with a number of workers taking up to batch requests at once
+        RecommendationServer(const string& path, int workers = 0, size_t batch = 16) : stopping(false), activeReaders(0) {
+            socketPath = path;
+            workerCount = workers > 0 ? workers : max(1, (int)thread::hardware_concurrency());
+            batchSize = max((size_t)1, batch);
+            listenFd = -1;
+            minConfidence = 0.6;
+            maxWorkloadSize = 1 << 20;
+            maxLineLength = 64 * 1024;
+            cacheCapacity = 4096;
+            nextEntryId = 0;
+            latencySampleSize = 4096;
+            requests = 0;
+            cacheHits = 0;
+            batches = 0;
+        }
+
+        RecommendationServer(const RecommendationServer&) = delete; // The workers point back at the server
+        RecommendationServer& operator=(const RecommendationServer&) = delete;
+
+        // A method that loads a trained recommender to answer confident queries without measuring
+        void loadModel(const string& path, double confidence) {
+            model = DecisionTreeRecommender::load(path);
+            minConfidence = confidence;
+        }
+
+        // A method that sets the largest workload size the server measures, the longest request line it reads and the
+        // most answers it caches, throwing invalid_argument if any of them is below one
+        void setLimits(long long maxSize, size_t maxLine, size_t cachedAnswers) {
+            if (maxSize < 1 || maxLine < 1 || cachedAnswers < 1) {
+                throw invalid_argument("The server's limits must be at least one");
+            }
+            maxWorkloadSize = maxSize;
+            maxLineLength = maxLine;
+            cacheCapacity = cachedAnswers;
+        }
+
+        // A method that returns the service's counters and latency percentiles as one line
+        string statistics() {
+            vector<long long> sample;
+            stringstream line;
+            {
+                lock_guard<mutex> lock(metricsMutex);
+                sample = latencySample;
+                line << "ok requests=" << requests << " cache_hits=" << cacheHits << " batches=" << batches;
+            }
+            line << " p50_us=" << latency_percentile(sample, 0.50) << " p99_us=" << latency_percentile(sample, 0.99);
+            return line.str();
+        }
+
+        // A method that serves requests until stop is called, throwing runtime_error if the socket cannot be set up
+        void run() {
+            sockaddr_un address;
+            memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            if (socketPath.size() >= sizeof(address.sun_path)) {
+                throw runtime_error("The socket path " + socketPath + " is too long");
+            }
+            strcpy(address.sun_path, socketPath.c_str());
+            listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (listenFd < 0) {
+                throw runtime_error("Cannot create a socket");
+            }
+            struct stat existing;
+            if (lstat(socketPath.c_str(), &existing) == 0) { // Only a stale socket from an earlier run may be replaced
+                if (!S_ISSOCK(existing.st_mode)) {
+                    close(listenFd);
+                    throw runtime_error(socketPath + " exists and is not a socket");
+                }
+                int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+                bool live = probe >= 0 && connect(probe, (sockaddr*)&address, sizeof(address)) == 0;
+                if (probe >= 0) {
+                    close(probe);
+                }
+                if (live) {
+                    close(listenFd);
+                    throw runtime_error("Another server is listening on " + socketPath);
+                }
+                unlink(socketPath.c_str());
+            }
+            if (bind(listenFd, (sockaddr*)&address, sizeof(address)) != 0 || listen(listenFd, 64) != 0) {
+                close(listenFd);
+                throw runtime_error("Cannot listen on " + socketPath + ": " + strerror(errno));
+            }
+
+            vector<thread> workers;
+            for (int t = 0; t < workerCount; t++) {
+                workers.push_back(thread(&RecommendationServer::work, this));
+            }
+            while (!stopping) {
+                pollfd ready = {listenFd, POLLIN, 0};
+                if (poll(&ready, 1, 200) <= 0) {
+                    continue;
+                }
+                int client = accept(listenFd, nullptr, nullptr);
+                if (client >= 0) {
+                    // Readers are detached so a busy service does not pile up finished threads; run counts them out instead
+                    activeReaders++;
+                    shared_ptr<Connection> connection = make_shared<Connection>(client);
+                    thread([this, connection] {
+                        read(connection);
+                        activeReaders--;
+                    }).detach();
+                }
+            }
+
+            while (activeReaders > 0) { // Each reader notices stopping within one poll interval
+                this_thread::sleep_for(chrono::milliseconds(10));
+            }
+            queueReady.notify_all();
+            for (thread& worker : workers) {
+                worker.join();
+            }
+            close(listenFd);
+            unlink(socketPath.c_str());
+        }
+
+        // A method that makes run return once the requests already queued are answered
+        void stop() {
+            stopping = true;
+            queueReady.notify_all();
+        }
+
+        // A method that serves requests until the process gets SIGINT or SIGTERM. The signals are blocked in every thread
+        // and picked up by one waiting thread, since stop is not safe to call from a signal handler.
+        void runUntilSignalled() {
+            sigset_t signals;
+            sigemptyset(&signals);
+            sigaddset(&signals, SIGINT);
+            sigaddset(&signals, SIGTERM);
+            pthread_sigmask(SIG_BLOCK, &signals, nullptr); // Threads started from here on inherit the mask
+            thread([this, signals] {
+                int signal = 0;
+                sigwait(&signals, &signal);
+                stop();
+            }).detach();
+            run();
+        }
+
+        // A static method that sends requests to a running server, one per line, and returns its answers in the order
+        // they arrive, throwing runtime_error if the socket path is too long or the server cannot be reached
+        static vector<string> query(const string& path, const vector<string>& specs) {
+            sockaddr_un address;
+            memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(address.sun_path)) {
+                throw runtime_error("The socket path " + path + " is too long");
+            }
+            strcpy(address.sun_path, path.c_str());
+            int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd < 0 || connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+                if (fd >= 0) {
+                    close(fd);
+                }
+                throw runtime_error("Cannot connect to " + path);
+            }
+            Connection connection(fd);
+            size_t expected = 0;
+            for (const string& spec : specs) {
+                if (!trim_lower(spec).empty()) { // The server skips blank lines, so they get no answer
+                    send(connection, spec);
+                    expected++;
+                }
+            }
+            vector<string> replies;
+            string buffer;
+            char chunk[4096];
+            while (replies.size() < expected) {
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    break;
+                }
+                buffer.append(chunk, n);
+                size_t end;
+                while ((end = buffer.find('\n')) != string::npos) {
+                    replies.push_back(buffer.substr(0, end));
+                    buffer.erase(0, end + 1);
+                }
+            }
+            return replies;
+        }
+};
+#endif
@@ -0,0 +1,360 @@
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include "ContainerRegistry.h"
+#include "RequirementParser.h"
+#include "Ranking.h"
+#include "BenchmarkRace.h"
+using namespace std;
+
+// A learned recommender, so interactive queries need not run a benchmark. Offline, train_recommender sweeps many random
+// workload profiles, races and ranks the candidates for each one, and fits a decision tree from the profile's features
+// (operation mix, log of the size, key type and the requirements that narrow the candidates) to the container that won. The tree is saved as a small text file.
+// Online, the tree's leaf for a profile holds how often each container won on similar profiles; restricted to the
+// candidates the profile allows, that gives a ranked recommendation and a confidence, and a caller measures for real
+// when the confidence is low or the profile's size lies outside the sizes the tree was trained on. The features leave
+// out the distribution of the keys, since the benchmark data is always distinct keys in random order: the tree cannot
+// tell a skewed or presorted workload from a uniform one.
+
+// The operations whose share of the workload the recommender reads, in feature order
+inline const vector<string> recommender_operations = {"insert()", "delete()", "search()", "size()", "sort()"};
+
+// The number of features of a profile
+inline const int recommender_feature_count = (int)recommender_operations.size() + 4;
+
+// A function that returns the features of a profile: the share of each recommender operation, log2 of the largest
+// size, the key type as 0 (string), 1 (int) or 2 (double), whether it needs random access and its Ordering as a number
+inline vector<double> profile_features(const WorkloadProfile& profile) {
+    vector<double> features;
+    for (const string& operation : recommender_operations) {
+        features.push_back(profile.frequency(operation));
+    }
+    features.push_back(log2((double)max(1LL, profile.maxSize)));
+    features.push_back(profile.keyType == "int" ? 1 : profile.keyType == "double" ? 2 : 0);
+    features.push_back(profile.randomAccess ? 1 : 0);
+    features.push_back((double)profile.ordering);
+    return features;
+}
+
+// A class for a decision tree that maps workload features to the container that wins. Each split is the feature and
+// threshold that most reduce the Gini impurity of the winners; a leaf keeps the count of every container's wins.
+class DecisionTreeRecommender {
+    private:
+        // One node of the tree: a split, or a leaf when feature is -1
+        struct TreeNode {
+            int feature = -1; // The feature compared at this node
+            double threshold = 0; // Samples with the feature at most this go left, the rest right
+            int left = -1; // The index of the left child
+            int right = -1; // The index of the right child
+            vector<int> counts; // At a leaf, the number of training wins of each class
+        };
+
+        vector<string> classes; // The container names the tree can recommend
+        vector<TreeNode> nodes; // The nodes of the tree, with the root first
+        int maxDepth; // The deepest a leaf may be
+        int minLeaf; // The fewest samples on each side of a split
+        double minLogSize = 6; // log2 of the smallest size the tree was trained on
+        double maxLogSize = 12; // log2 of the largest size the tree was trained on
+
+        // A helper method that returns the Gini impurity of a list of class counts over a given total
+        static double gini(const vector<int>& counts, int total) {
+            if (total == 0) {
+                return 0;
+            }
+            double sum = 0;
+            for (int c : counts) {
+                sum += (double)c * c;
+            }
+            return 1 - sum / ((double)total * total);
+        }
+
+        // A helper method that builds the subtree for the samples at the given indexes and returns the index of its root
+        int build(const vector<vector<double>>& features, const vector<int>& labels, vector<int>& indexes, int depth) {
+            int index = (int)nodes.size();
+            nodes.push_back(TreeNode());
+            vector<int> counts(classes.size(), 0);
+            for (int i : indexes) {
+                counts[labels[i]]++;
+            }
+            int total = (int)indexes.size();
+            double impurity = gini(counts, total);
+
+            int bestFeature = -1;
+            double bestThreshold = 0;
+            double bestImpurity = impurity - 1e-9; // A split has to improve on the node itself
+            if (depth < maxDepth && impurity > 0 && total >= 2 * minLeaf) {
+                for (size_t f = 0; f < features[0].size(); f++) {
+                    sort(indexes.begin(), indexes.end(), [&](int a, int b) { return features[a][f] < features[b][f]; });
+                    vector<int> leftCounts(classes.size(), 0);
+                    vector<int> rightCounts = counts;
+                    for (int k = 0; k + 1 < total; k++) { // Try every cut between two distinct values, left to right
+                        leftCounts[labels[indexes[k]]]++;
+                        rightCounts[labels[indexes[k]]]--;
+                        double value = features[indexes[k]][f];
+                        double next = features[indexes[k + 1]][f];
+                        int leftSize = k + 1;
+                        if (value == next || leftSize < minLeaf || total - leftSize < minLeaf) {
+                            continue;
+                        }
+                        double split = (leftSize * gini(leftCounts, leftSize) + (total - leftSize) * gini(rightCounts, total - leftSize)) / total;
+                        if (split < bestImpurity) {
+                            bestImpurity = split;
+                            bestFeature = (int)f;
+                            bestThreshold = (value + next) / 2;
+                        }
+                    }
+                }
+            }
+
+            if (bestFeature < 0) {
+                nodes[index].counts = counts;
+                return index;
+            }
+            vector<int> leftIndexes;
+            vector<int> rightIndexes;
+            for (int i : indexes) {
+                (features[i][bestFeature] <= bestThreshold ? leftIndexes : rightIndexes).push_back(i);
+            }
+            int left = build(features, labels, leftIndexes, depth + 1);
+            int right = build(features, labels, rightIndexes, depth + 1);
+            nodes[index].feature = bestFeature; // Set through the index, since building the children may move the nodes
+            nodes[index].threshold = bestThreshold;
+            nodes[index].left = left;
+            nodes[index].right = right;
+            return index;
+        }
+
+    public:
+        // A constructor that creates an empty tree that will grow to a given depth with at least minLeafSamples per leaf
+        DecisionTreeRecommender(int depth = 6, int minLeafSamples = 3) {
+            maxDepth = depth;
+            minLeaf = max(1, minLeafSamples);
+        }
+
+        // A method that fits the tree to a list of feature vectors and the name of the container that won for each one,
+        // throwing invalid_argument if there are no samples or the lists differ in length
+        void fit(const vector<vector<double>>& features, const vector<string>& winners) {
+            if (features.empty() || features.size() != winners.size()) {
+                throw invalid_argument("The recommender needs one winner for each of at least one feature vector");
+            }
+            classes.clear();
+            nodes.clear();
+            vector<int> labels;
+            for (const string& winner : winners) {
+                auto it = find(classes.begin(), classes.end(), winner);
+                if (it == classes.end()) {
+                    classes.push_back(winner);
+                    it = classes.end() - 1;
+                }
+                labels.push_back((int)(it - classes.begin()));
+            }
+            vector<int> indexes(features.size());
+            for (size_t i = 0; i < indexes.size(); i++) {
+                indexes[i] = (int)i;
+            }
+            build(features, labels, indexes, 0);
+        }
+
+        // A method that checks if the tree has been fitted or loaded
+        bool isTrained() const {
+            return !nodes.empty();
+        }
+
+        // A method that records the range of sizes the tree was trained on, as log2 of the smallest and largest
+        void setTrainedSizes(double minLog, double maxLog) {
+            minLogSize = minLog;
+            maxLogSize = maxLog;
+        }
+
+        // A method that checks if the size in a feature vector lies within the sizes the tree was trained on
+        bool coversSize(const vector<double>& features) const {
+            double logSize = features[recommender_operations.size()];
+            return logSize >= minLogSize - 1e-9 && logSize <= maxLogSize + 1e-9;
+        }
+
+        // A method that returns the allowed containers ranked by their wins in the leaf for the given features, each with
+        // its share of the allowed wins. The share is shrunk toward zero in a sparse leaf, so with n wins the top share is
+        // at most n / (n + 1), and it serves as the confidence of the recommendation. A size outside the trained range gets
+        // an empty ranking, since the tree would only be guessing there.
+        vector<pair<string,double>> rank(const vector<double>& features, const vector<string>& allowed) const {
+            vector<pair<string,double>> ranking;
+            if (nodes.empty() || !coversSize(features)) {
+                return ranking;
+            }
+            int node = 0;
+            while (nodes[node].feature >= 0) {
+                node = features[nodes[node].feature] <= nodes[node].threshold ? nodes[node].left : nodes[node].right;
+            }
+            const vector<int>& counts = nodes[node].counts;
+            int total = 0;
+            for (size_t c = 0; c < classes.size(); c++) {
+                if (find(allowed.begin(), allowed.end(), classes[c]) != allowed.end()) {
+                    total += counts[c];
+                }
+            }
+            for (const string& ds : allowed) {
+                auto it = find(classes.begin(), classes.end(), ds);
+                int wins = it == classes.end() ? 0 : counts[it - classes.begin()];
+                ranking.push_back(make_pair(ds, (double)wins / (total + 1)));
+            }
+            stable_sort(ranking.begin(), ranking.end(), [](const pair<string,double>& a, const pair<string,double>& b) { return a.second > b.second; });
+            return ranking;
+        }
+
+        // A method that writes the tree to a text file, throwing runtime_error if it cannot be written
+        void save(const string& path) const {
+            ofstream out(path);
+            if (!out) {
+                throw runtime_error("Cannot write " + path);
+            }
+            out.precision(17);
+            out << "recommender 2 " << classes.size() << " " << nodes.size() << " " << minLogSize << " " << maxLogSize << "\n";
+            for (const string& name : classes) {
+                out << name << "\n"; // Names may hold spaces, so each gets a line of its own
+            }
+            for (const TreeNode& n : nodes) {
+                if (n.feature >= 0) {
+                    out << "split " << n.feature << " " << n.threshold << " " << n.left << " " << n.right << "\n";
+                }
+                else {
+                    out << "leaf";
+                    for (int c : n.counts) {
+                        out << " " << c;
+                    }
+                    out << "\n";
+                }
+            }
+        }
+
+        // A static method that reads a tree written by save, throwing runtime_error if the file is missing or malformed.
+        // A version 1 file has no size range, and was always trained on sizes 2^6 to 2^12.
+        static DecisionTreeRecommender load(const string& path) {
+            ifstream in(path);
+            if (!in) {
+                throw runtime_error("Cannot open " + path);
+            }
+            string magic;
+            int version = 0;
+            size_t classCount = 0;
+            size_t nodeCount = 0;
+            if (!(in >> magic >> version >> classCount >> nodeCount) || magic != "recommender" || (version != 1 && version != 2) || nodeCount == 0) {
+                throw runtime_error(path + " is not a recommender model");
+            }
+            DecisionTreeRecommender tree;
+            if (version == 2 && !(in >> tree.minLogSize >> tree.maxLogSize)) {
+                throw runtime_error(path + " has no trained size range");
+            }
+            string line;
+            getline(in, line);
+            for (size_t c = 0; c < classCount; c++) {
+                if (!getline(in, line)) {
+                    throw runtime_error(path + " ends before its container names");
+                }
+                tree.classes.push_back(line);
+            }
+            for (size_t i = 0; i < nodeCount; i++) {
+                TreeNode n;
+                string kind;
+                in >> kind;
+                if (kind == "split") {
+                    in >> n.feature >> n.threshold >> n.left >> n.right;
+                    if (n.feature < 0 || n.feature >= recommender_feature_count || n.left <= (int)i || n.right <= (int)i
+                        || n.left >= (int)nodeCount || n.right >= (int)nodeCount) {
+                        throw runtime_error(path + " has a bad split at node " + to_string(i));
+                    }
+                }
+                else if (kind == "leaf") {
+                    n.counts.resize(classCount);
+                    for (int& c : n.counts) {
+                        in >> c;
+                    }
+                }
+                else {
+                    throw runtime_error(path + " has an unknown node kind \"" + kind + "\"");
+                }
+                if (!in) {
+                    throw runtime_error(path + " ends in the middle of node " + to_string(i));
+                }
+                tree.nodes.push_back(n);
+            }
+            return tree;
+        }
+};
+
+// A function that trains a recommender on a number of random workload profiles: each gets a random mix of the recommender
+// operations, a size between minSize and maxSize spread evenly on a log scale, a random key type and random ordering and
+// random access requirements, and is labelled with the container that the race and the Pareto ranking pick among the
+// candidates it allows. Progress goes to log if one is given. A sample whose benchmark fails is skipped. Throws
+// invalid_argument for fewer than one sample, a bad size range, or when no sample had any candidate to learn from.
+inline DecisionTreeRecommender train_recommender(int samples, unsigned seed = 1, long long minSize = 64, long long maxSize = 4096,
+                                                 ostream* log = nullptr) {
+    if (samples < 1) {
+        throw invalid_argument("The recommender needs at least one training sample");
+    }
+    if (minSize < 1 || minSize > maxSize) {
+        throw invalid_argument("The training sizes must be a range of positive sizes, smallest first");
+    }
+    double minLog = log2((double)minSize);
+    double maxLog = log2((double)maxSize);
+    mt19937 rng(seed);
+    exponential_distribution<double> share(1.0); // Normalized exponentials give mixes spread evenly over the simplex
+    uniform_real_distribution<double> logSize(minLog, maxLog);
+    vector<string> keyTypes = {"string", "int", "double"};
+    RankingWeights weights;
+
+    vector<vector<double>> features;
+    vector<string> winners;
+    for (int s = 0; s < samples; s++) {
+        WorkloadProfile profile;
+        profile.operations = recommender_operations;
+        double sum = 0;
+        for (size_t j = 0; j < recommender_operations.size(); j++) {
+            profile.frequencies.push_back(share(rng));
+            sum += profile.frequencies.back();
+        }
+        for (double& f : profile.frequencies) {
+            f /= sum;
+        }
+        profile.maxSize = profile.minSize = min(maxSize, max(minSize, (long long)pow(2.0, logSize(rng))));
+        profile.keyType = keyTypes[rng() % keyTypes.size()];
+        profile.randomAccess = rng() % 4 == 0;
+        profile.ordering = (Ordering)(rng() % 5);
+        vector<string> candidates = filter_candidates(profile);
+        if (candidates.empty()) { // No container meets these requirements, so there is nothing to learn
+            continue;
+        }
+
+        vector<string> data = generate_workload_data(profile, seed + s);
+        string winner;
+        try {
+            RaceResult race = race_candidates(candidates, profile.operations, data, profile.frequencies);
+            winner = get_pareto_best_data_structure(race.finalists, weights);
+        }
+        catch (const exception& e) { // One workload the benchmark cannot run should not cost the whole sweep
+            if (log != nullptr) {
+                *log << "sample " << s + 1 << "/" << samples << ": skipped, " << e.what() << endl;
+            }
+            continue;
+        }
+        features.push_back(profile_features(profile));
+        winners.push_back(winner);
+        if (log != nullptr) {
+            *log << "sample " << s + 1 << "/" << samples << ": " << profile.maxSize << " " << profile.keyType << " keys, "
+                 << candidates.size() << " candidates -> " << winner << endl;
+        }
+    }
+
+    if (features.empty()) {
+        throw invalid_argument("No training sample had a container to recommend");
+    }
+    DecisionTreeRecommender tree;
+    tree.fit(features, winners);
+    tree.setTrainedSizes(minLog, maxLog);
+    return tree;
+}
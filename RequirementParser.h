@@ -0,0 +1,446 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <cctype>
+#include "ContainerTraits.h"
+using namespace std;
+
+// A parser for requirement specs, the description of a workload the search engine should recommend a container for.
+// A spec has one "key: value" requirement per line (or separated by semicolons):
+//
+//     operations: insert 40%, search 50%, delete 10%
+//     ordering: sorted              (none, insertion, sorted, fifo or lifo)
+//     iteration: yes
+//     random access: no
+//     concurrency: 8 threads
+//     memory: 64MB
+//     size: 1k..1M
+//     key: int                      (string, int or double)
+//
+// Operation frequencies may be percentages, fractions or plain weights. Operations without one share whatever the others
+// leave of 100%, or count as average ones when nothing is left. Every registered container holds its keys as strings,
+// so the key type only decides what the generated keys look like (digits for int and double), and memory is estimated
+// for string keys either way. Text without any "key: value" lines is read the old way, as keywords such as
+// "random access sorting insertion", where "insertion" and "deletion" ask for containers that insert or delete in
+// constant time.
+
+// The order a workload needs its elements in
+enum class Ordering {
+    None, // Any order will do
+    Insertion, // Elements come back in the order they were added
+    Sorted, // Elements come back in key order
+    Fifo, // Only the oldest element is taken out
+    Lifo // Only the newest element is taken out
+};
+
+// The structured form of a requirement spec
+struct WorkloadProfile {
+    vector<string> operations; // The engine methods the workload calls, such as "insert()" or "search()"
+    vector<double> frequencies; // The share of calls going to each operation, adding up to 1
+    Ordering ordering = Ordering::None;
+    bool iteration = false; // Whether the workload walks over every element
+    bool randomAccess = false; // Whether elements are read by position or key without a search
+    bool graph = false; // Whether the workload is about vertices and edges (traversals, paths)
+    int threads = 1; // The number of threads calling the container at once
+    long long memoryBudget = 0; // The bytes the container may use at its largest size, or 0 for no limit
+    long long minSize = 1000; // The smallest number of elements the container holds
+    long long maxSize = 1000; // The largest number of elements the container holds
+    string keyType = "string"; // The shape of the generated keys: "string", "int" or "double"
+    bool constantInsert = false; // Whether insert() must take constant time, as the keyword "insertion" asks
+    bool constantDelete = false; // Whether delete() must take constant time, as the keyword "deletion" asks
+
+    // A method that returns the share of calls going to a given operation, or 0 if the workload never calls it
+    double frequency(const string& operation) const {
+        for (size_t i = 0; i < operations.size(); i++) {
+            if (operations[i] == operation) {
+                return frequencies[i];
+            }
+        }
+        return 0;
+    }
+};
+
+// A helper function that returns a copy of a string in lower case with surrounding blanks removed
+inline string trim_lower(const string& text) {
+    size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == string::npos) {
+        return "";
+    }
+    size_t last = text.find_last_not_of(" \t\r\n");
+    string result = text.substr(first, last - first + 1);
+    for (char& c : result) {
+        c = (char)tolower((unsigned char)c);
+    }
+    return result;
+}
+
+// A helper function that reads a yes/no requirement value
+inline bool parse_flag(const string& value) {
+    if (value == "yes" || value == "true" || value == "1" || value == "required" || value == "on") {
+        return true;
+    }
+    if (value == "no" || value == "false" || value == "0" || value == "none" || value == "off") {
+        return false;
+    }
+    throw invalid_argument("Expected yes or no, got \"" + value + "\"");
+}
+
+// A helper function that reads a count such as 2500, 1e6, 10k, 4M or 1G
+inline long long parse_count(const string& value) {
+    size_t used = 0;
+    double number;
+    try {
+        number = stod(value, &used);
+    }
+    catch (const exception&) {
+        throw invalid_argument("Expected a number, got \"" + value + "\"");
+    }
+    string suffix = trim_lower(value.substr(used));
+    if (suffix == "k") {
+        number *= 1e3;
+    }
+    else if (suffix == "m") {
+        number *= 1e6;
+    }
+    else if (suffix == "g" || suffix == "b") {
+        number *= 1e9;
+    }
+    else if (!suffix.empty()) {
+        throw invalid_argument("Unknown count suffix \"" + suffix + "\"");
+    }
+    if (number < 0) {
+        throw invalid_argument("Counts cannot be negative");
+    }
+    return (long long)number;
+}
+
+// A helper function that reads a memory size such as 4096, 512 KB, 64MB or 2 GiB as bytes, in binary units
+inline long long parse_bytes(const string& value) {
+    size_t used = 0;
+    double number;
+    try {
+        number = stod(value, &used);
+    }
+    catch (const exception&) {
+        throw invalid_argument("Expected a memory size, got \"" + value + "\"");
+    }
+    string unit = trim_lower(value.substr(used));
+    if (unit.size() > 1 && unit.back() == 'b') { // KB, MiB and the like all end in b
+        unit.pop_back();
+    }
+    if (!unit.empty() && unit.back() == 'i') {
+        unit.pop_back();
+    }
+    if (unit == "k") {
+        number *= 1024.0;
+    }
+    else if (unit == "m") {
+        number *= 1024.0 * 1024;
+    }
+    else if (unit == "g") {
+        number *= 1024.0 * 1024 * 1024;
+    }
+    else if (!unit.empty() && unit != "b" && unit != "bytes" && unit != "byte") {
+        throw invalid_argument("Unknown memory unit \"" + unit + "\"");
+    }
+    return (long long)number;
+}
+
+// A helper function that maps an operation word to the engine method it stands for, or "" for words that set a flag instead
+inline string operation_method(const string& word, WorkloadProfile& profile) {
+    if (word == "insert" || word == "insertion" || word == "add" || word == "push" || word == "append" || word == "enqueue") {
+        return "insert()";
+    }
+    if (word == "delete" || word == "deletion" || word == "remove" || word == "pop" || word == "erase" || word == "dequeue") {
+        return "delete()";
+    }
+    if (word == "search" || word == "find" || word == "lookup" || word == "contains") {
+        return "search()";
+    }
+    if (word == "size" || word == "count") {
+        return "size()";
+    }
+    if (word == "sort" || word == "sorting") {
+        return "sort()";
+    }
+    if (word == "iterate" || word == "iteration" || word == "scan") {
+        profile.iteration = true;
+        return "";
+    }
+    if (word == "random access" || word == "access" || word == "index" || word == "get") {
+        profile.randomAccess = true;
+        return "";
+    }
+    if (word == "traverse" || word == "traversal" || word == "bfs" || word == "dfs" || word == "shortest path" || word == "edges") {
+        profile.graph = true;
+        return "";
+    }
+    throw invalid_argument("Unknown operation \"" + word + "\"");
+}
+
+// A helper function that reads an operations list such as "insert 40%, search 0.5, delete" into the profile
+inline void parse_operations(const string& value, WorkloadProfile& profile) {
+    vector<string> methods;
+    vector<double> weights; // A negative weight means none was given
+    stringstream items(value);
+    string item;
+    while (getline(items, item, ',')) {
+        item = trim_lower(item);
+        if (item.empty()) {
+            continue;
+        }
+        double weight = -1;
+        size_t split = item.find_last_of(" \t");
+        if (split != string::npos && (isdigit((unsigned char)item[split + 1]) || item[split + 1] == '.')) {
+            string amount = item.substr(split + 1);
+            item = trim_lower(item.substr(0, split));
+            bool percent = !amount.empty() && amount.back() == '%';
+            if (percent) {
+                amount.pop_back();
+            }
+            try {
+                weight = stod(amount);
+            }
+            catch (const exception&) {
+                throw invalid_argument("Bad frequency \"" + amount + "\" for " + item);
+            }
+            if (percent) {
+                weight /= 100;
+            }
+        }
+        string method = operation_method(item, profile);
+        if (method.empty()) {
+            continue;
+        }
+        auto existing = find(methods.begin(), methods.end(), method);
+        if (existing != methods.end()) { // Aliases such as add and insert pool their weights
+            double& w = weights[existing - methods.begin()];
+            w = (w < 0 || weight < 0) ? max(w, weight) : w + weight;
+        }
+        else {
+            methods.push_back(method);
+            weights.push_back(weight);
+        }
+    }
+    double given = 0; // The total of the frequencies that were written out
+    int missing = 0;
+    for (double w : weights) {
+        if (w < 0) {
+            missing++;
+        }
+        else {
+            given += w;
+        }
+    }
+    double share = missing > 0 ? max(0.0, 1.0 - given) / missing : 0; // Unweighted operations split what is left
+    if (missing > 0 && share == 0) {
+        share = given / (weights.size() - missing); // The given weights used everything up, so count the rest as average ones
+    }
+    double total = 0;
+    for (double& w : weights) {
+        if (w < 0) {
+            w = share;
+        }
+        total += w;
+    }
+    profile.operations = methods;
+    profile.frequencies.clear();
+    for (double w : weights) {
+        profile.frequencies.push_back(total > 0 ? w / total : 1.0 / weights.size());
+    }
+}
+
+// A helper function that reads a size such as 5000, up to 1M, or a range such as 1k..1M, 1k-1M or 1k to 1M, throwing
+// invalid_argument for a largest size below one element, which no benchmark can run on
+inline void parse_size_range(const string& value, WorkloadProfile& profile) {
+    string text = value;
+    bool parsed = false;
+    if (text.rfind("up to ", 0) == 0) {
+        profile.maxSize = parse_count(text.substr(6));
+        profile.minSize = min(profile.minSize, profile.maxSize);
+        parsed = true;
+    }
+    for (const string separator : {"..", " to ", "-"}) {
+        size_t at = text.find(separator);
+        if (!parsed && at != string::npos && at > 0) {
+            profile.minSize = parse_count(trim_lower(text.substr(0, at)));
+            profile.maxSize = parse_count(trim_lower(text.substr(at + separator.size())));
+            if (profile.minSize > profile.maxSize) {
+                throw invalid_argument("The size range " + value + " is backwards");
+            }
+            parsed = true;
+        }
+    }
+    if (!parsed) {
+        profile.minSize = profile.maxSize = parse_count(text);
+    }
+    if (profile.maxSize < 1) {
+        throw invalid_argument("The size must be at least one element");
+    }
+}
+
+// A helper function that reads the old free-form API strings, where keywords such as "random access", "sorting",
+// "insertion" and "ordered" anywhere in the text turn requirements on
+inline WorkloadProfile parse_keywords(const string& text) {
+    WorkloadProfile profile;
+    string lower = trim_lower(text);
+    if (lower.find("random access") != string::npos) {
+        profile.randomAccess = true;
+    }
+    if (lower.find("sorting") != string::npos) {
+        profile.ordering = Ordering::Sorted;
+    }
+    else if (lower.find("ordered") != string::npos) {
+        profile.ordering = Ordering::Insertion;
+    }
+    if (lower.find("insertion") != string::npos) {
+        profile.constantInsert = true;
+    }
+    if (lower.find("deletion") != string::npos) {
+        profile.constantDelete = true;
+    }
+    if (profile.constantInsert || profile.constantDelete) {
+        profile.operations = {"insert()", "delete()"};
+        profile.frequencies = {0.5, 0.5};
+    }
+    return profile;
+}
+
+// A function that parses a requirement spec into a workload profile, throwing invalid_argument with the offending
+// line when a requirement is unknown or malformed
+inline WorkloadProfile parse_requirements(const string& spec) {
+    if (spec.find(':') == string::npos) {
+        return parse_keywords(spec);
+    }
+    WorkloadProfile profile;
+    profile.operations = {"insert()", "delete()", "search()", "size()", "sort()"}; // The engine's default API until a spec says otherwise
+    profile.frequencies.assign(5, 0.2);
+    string normalized = spec;
+    replace(normalized.begin(), normalized.end(), ';', '\n');
+    stringstream lines(normalized);
+    string line;
+    while (getline(lines, line)) {
+        string text = trim_lower(line);
+        if (text.empty() || text[0] == '#') {
+            continue;
+        }
+        size_t colon = text.find(':');
+        if (colon == string::npos) {
+            throw invalid_argument("Expected \"key: value\" in \"" + line + "\"");
+        }
+        string key = trim_lower(text.substr(0, colon));
+        string value = trim_lower(text.substr(colon + 1));
+        try {
+            if (key == "operations" || key == "ops") {
+                parse_operations(value, profile);
+            }
+            else if (key == "ordering" || key == "order") {
+                if (value == "none" || value == "any") {
+                    profile.ordering = Ordering::None;
+                }
+                else if (value == "insertion" || value == "ordered") {
+                    profile.ordering = Ordering::Insertion;
+                }
+                else if (value == "sorted" || value == "sorting") {
+                    profile.ordering = Ordering::Sorted;
+                }
+                else if (value == "fifo" || value == "queue") {
+                    profile.ordering = Ordering::Fifo;
+                }
+                else if (value == "lifo" || value == "stack") {
+                    profile.ordering = Ordering::Lifo;
+                }
+                else {
+                    throw invalid_argument("Unknown ordering \"" + value + "\"");
+                }
+            }
+            else if (key == "iteration") {
+                profile.iteration = parse_flag(value);
+            }
+            else if (key == "random access") {
+                profile.randomAccess = parse_flag(value);
+            }
+            else if (key == "graph") {
+                profile.graph = parse_flag(value);
+            }
+            else if (key == "concurrency" || key == "threads") {
+                if (value == "none" || value == "single" || value == "no") {
+                    profile.threads = 1;
+                }
+                else {
+                    string count = value.substr(0, value.find(' ')); // Allows "8 threads"
+                    profile.threads = max(1, (int)parse_count(count));
+                }
+            }
+            else if (key == "memory" || key == "memory budget") {
+                profile.memoryBudget = (value == "none" || value == "unlimited") ? 0 : parse_bytes(value);
+            }
+            else if (key == "size") {
+                parse_size_range(value, profile);
+            }
+            else if (key == "key" || key == "key type") {
+                if (value != "string" && value != "int" && value != "double") {
+                    throw invalid_argument("Unknown key type \"" + value + "\"");
+                }
+                profile.keyType = value;
+            }
+            else {
+                throw invalid_argument("Unknown requirement \"" + key + "\"");
+            }
+        }
+        catch (const invalid_argument& e) {
+            throw invalid_argument(string(e.what()) + " in \"" + trim_lower(line) + "\"");
+        }
+    }
+    return profile;
+}
+
+// A function that returns the capabilities a container needs to serve a profile: each requirement adds its own bits,
+// so requirements combine by intersection instead of needing a case for every combination
+inline unsigned required_capabilities(const WorkloadProfile& profile) {
+    unsigned required = profile.graph ? GraphQueries : Elements; // Graph workloads and element workloads never share a container
+    if (profile.randomAccess) {
+        required |= RandomAccess;
+    }
+    if (profile.iteration) {
+        required |= Iteration;
+    }
+    if (profile.ordering == Ordering::Sorted) {
+        required |= SortedOrder;
+    }
+    else if (profile.ordering == Ordering::Insertion) {
+        required |= InsertionOrder;
+    }
+    else if (profile.ordering == Ordering::Fifo) {
+        required |= FifoOrder;
+    }
+    else if (profile.ordering == Ordering::Lifo) {
+        required |= LifoOrder;
+    }
+    return required;
+}
+
+// A function that generates the benchmark data for a profile: maxSize distinct keys of its key type, shuffled, so every
+// container is measured at the largest size the workload reaches
+inline vector<string> generate_workload_data(const WorkloadProfile& profile, unsigned seed = 1) {
+    vector<string> data;
+    data.reserve(profile.maxSize);
+    mt19937 rng(seed);
+    for (long long i = 0; i < profile.maxSize; i++) {
+        if (profile.keyType == "int") {
+            data.push_back(to_string(i * 7919 % 1000003 + 1000003 * (i / 1000003))); // Distinct and spread out, not sequential
+        }
+        else if (profile.keyType == "double") {
+            data.push_back(to_string(i * 1.5));
+        }
+        else {
+            data.push_back("i" + to_string(i));
+        }
+    }
+    shuffle(data.begin(), data.end(), rng);
+    return data;
+}
@@ -3,13 +3,7 @@
 #include <string>
 #include <chrono>
 #include <numeric>
-#include "ToArray.h"
-#include "Stack.h"
-#include "Queue.h"
-#include "LinkedList.h"
-#include "BST.h"
-#include "Hash Table.h"
-#include "Graph.h"
+#include "ContainerRegistry.h"
 
 using namespace std;
 
@@ -21,36 +15,9 @@ public:
         // A vector to store the possible data structures
         vector<string> result;
 
-        // A flag to indicate if the API requires random access
-        bool random_access = false;
+        // Parse the requirement spec (or the old keyword string) into a structured workload profile
+        WorkloadProfile profile = parse_requirements(api);
 
-        // A flag to indicate if the API requires sorting
-        bool sorting = false;
-
-        // A flag to indicate if the API requires insertion or deletion at any position
-        bool insertion_deletion = false;
-
-        // A flag to indicate if the API requires ordered data
-        bool ordered_data = false;
-
-        // Parse the API string and set the flags accordingly
-        // This is a simplified example, you may need to use more sophisticated parsing techniques
-        if (api.find("random access") != string::npos) {
-            random_access = true;
-        }
-        if (api.find("sorting") != string::npos) {
-            sorting = true;
-        }
-        if (api.find("insertion") != string::npos || api.find("deletion") != string::npos) {
-            insertion_deletion = true;
-        }
-        if (api.find("ordered") != string::npos) {
-            ordered_data = true;
-        }
-        
-
-        // Filter out the data structures that are not suitable for the API
-        // This is a simplified example, you may need to use more sophisticated filtering techniques
         /*
             An Array allows random access to any element in constant times,
                 but it is slow in  insertion or delet element.
@@ -68,67 +35,8 @@ public:
                 but it requires a good hash function to avoid collisions and it may waste memory.
         */
 
-        if (!random_access && !sorting && !insertion_deletion && !ordered_data) {
-            // No specific requirement, any data structure can be used
-            result.push_back("array");
-            result.push_back("stack");
-            result.push_back("queue");
-            result.push_back("linked list");
-            result.push_back("tree");
-            result.push_back("hash table");
-            result.push_back("graphs");
-        } else if (random_access && !sorting && !insertion_deletion && !ordered_data) {
-            // Only random access required, array, vector, and hash table can be used
-            result.push_back("array");
-            result.push_back("hash table");
-        } else if (!random_access && sorting && !insertion_deletion && !ordered_data) {
-            // Only sorting required, linked list and tree can be used
-            result.push_back("linked list");
-            result.push_back("tree");
-        } else if (!random_access && !sorting && insertion_deletion && !ordered_data) {
-            // Only insertion or deletion required, linked list and hash table can be used
-            result.push_back("stack");
-            result.push_back("queue");
-            result.push_back("linked list");
-            result.push_back("hash table");
-        } else if (!random_access && !sorting && !insertion_deletion && ordered_data) {
-            // Only ordered data required, array, vector, linked list, and tree can be used
-            result.push_back("array");
-            result.push_back("stack");
-            result.push_back("queue");
-            result.push_back("linked list");
-            result.push_back("tree");
-        } else if (random_access && sorting && !insertion_deletion && !ordered_data) {
-            // Random access and sorting required, array and vector can be used
-            result.push_back("array");
-        } else if (random_access && !sorting && insertion_deletion && !ordered_data) {
-            // Random access and insertion or deletion required, vector and hash table can be used
-            result.push_back("hash table");
-        } else if (random_access && !sorting && !insertion_deletion && ordered_data) {
-            // Random access and ordered data required, array and vector can be used
-            result.push_back("array");
-        } else if (!random_access && sorting && insertion_deletion && !ordered_data) {
-            // Sorting and insertion or deletion required, linked list and tree can be used
-            result.push_back("linked list"); 
-            result.push_back("tree"); 
-        } else if (!random_access && sorting && !insertion_deletion && ordered_data) { 
-            // Sorting and ordered data required, linked list and tree can be used 
-            result.push_back("linked list"); 
-            result.push_back("tree"); 
-        } else if (!random_access && !sorting && insertion_deletion && ordered_data) { 
-            // Insertion or deletion and ordered data required, linked list and tree can be used 
-            result.push_back("linked list"); 
-            result.push_back("tree"); 
-        } else if (random_access && sorting && insertion_deletion && !ordered_data) { 
-            // Random access, sorting, and insertion or deletion required, no suitable data structure exists 
-            result.clear(); 
-        } else if (random_access && sorting && !insertion_deletion && ordered_data) { 
-            // Random access, sorting, and ordered data required, array and vector can be used 
-            result.push_back("array"); 
-        } else if (random_access && !sorting && insertion_deletion && ordered_data) { 
-            // Random access, insertion or deletion, and ordered data required, no suitable data structure exists 
-            result.clear(); 
-        }
+        // Keep the registered data structures that meet every requirement of the profile
+        result = filter_candidates(profile);
 
         // Rank the data structures based on their advantages and disadvantages for the API 
         // This is a simplified example, you may need to use more sophisticated ranking techniques
@@ -0,0 +1,178 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstring>
+#include <type_traits>
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+using namespace std;
+
+// Linear search helpers shared by the array-backed containers (ToArray, Stack, DynamicQueue).
+// Integral element types are compared a whole vector register at a time when the compiler
+// targets AVX2 or SSE4.2 (e.g. g++ -mavx2), strings are prefiltered on length and end bytes,
+// and everything else falls back to a plain scalar loop. The path is chosen at compile time.
+
+// A helper function that returns the position of the lowest set bit in a non-zero mask
+inline int lowest_set_bit(unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int bit = 0;
+    while ((mask & 1u) == 0) { // Shift until the lowest set bit reaches position zero
+        mask >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+// A trait that tells whether a type can be compared lane by lane in a vector register
+template <class T>
+struct is_simd_searchable {
+    static const bool value = is_integral<T>::value && !is_same<T, bool>::value
+        && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+};
+
+// A function that searches n elements one at a time and returns the index of the first match, or -1
+template <class T>
+int scalar_find(const T* data, int n, const T& value) {
+    for (int i = 0; i < n; i++) { // loop through the elements from 0 to n - 1
+        if (data[i] == value) { // if the current element is equal to the target element, return its index
+            return i;
+        }
+    }
+    return -1; // if the element is not found, return -1
+}
+
+#if defined(__AVX2__)
+// A helper function that broadcasts one integral value to every lane of a 256-bit register
+template <class T>
+inline __m256i simd_broadcast(T value) {
+    if constexpr (sizeof(T) == 1) return _mm256_set1_epi8((char)value);
+    else if constexpr (sizeof(T) == 2) return _mm256_set1_epi16((short)value);
+    else if constexpr (sizeof(T) == 4) return _mm256_set1_epi32((int)value);
+    else return _mm256_set1_epi64x((long long)value);
+}
+
+// A helper function that compares every lane of two 256-bit registers for equality
+template <class T>
+inline __m256i simd_equal(__m256i a, __m256i b) {
+    if constexpr (sizeof(T) == 1) return _mm256_cmpeq_epi8(a, b);
+    else if constexpr (sizeof(T) == 2) return _mm256_cmpeq_epi16(a, b);
+    else if constexpr (sizeof(T) == 4) return _mm256_cmpeq_epi32(a, b);
+    else return _mm256_cmpeq_epi64(a, b);
+}
+
+// A function that searches integral elements 32 bytes at a time and returns the index of the first match, or -1
+template <class T>
+int vector_find(const T* data, int n, const T& value) {
+    const int lanes = 32 / sizeof(T); // The number of elements compared per iteration
+    const __m256i needle = simd_broadcast<T>(value); // The target value copied into every lane
+    int i = 0;
+    for (; i + lanes <= n; i += lanes) { // Compare one full register per iteration
+        __m256i block = _mm256_loadu_si256((const __m256i*)(data + i));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(simd_equal<T>(block, needle)); // One bit per matching byte
+        if (mask != 0) { // At least one lane matched, so the lowest set bit belongs to the first match
+            return i + lowest_set_bit(mask) / (int)sizeof(T);
+        }
+    }
+    int rest = scalar_find(data + i, n - i, value); // Finish the tail that does not fill a register
+    return rest == -1 ? -1 : i + rest;
+}
+#elif defined(__SSE4_2__)
+// A helper function that broadcasts one integral value to every lane of a 128-bit register
+template <class T>
+inline __m128i simd_broadcast(T value) {
+    if constexpr (sizeof(T) == 1) return _mm_set1_epi8((char)value);
+    else if constexpr (sizeof(T) == 2) return _mm_set1_epi16((short)value);
+    else if constexpr (sizeof(T) == 4) return _mm_set1_epi32((int)value);
+    else return _mm_set1_epi64x((long long)value);
+}
+
+// A helper function that compares every lane of two 128-bit registers for equality
+template <class T>
+inline __m128i simd_equal(__m128i a, __m128i b) {
+    if constexpr (sizeof(T) == 1) return _mm_cmpeq_epi8(a, b);
+    else if constexpr (sizeof(T) == 2) return _mm_cmpeq_epi16(a, b);
+    else if constexpr (sizeof(T) == 4) return _mm_cmpeq_epi32(a, b);
+    else return _mm_cmpeq_epi64(a, b);
+}
+
+// A function that searches integral elements 16 bytes at a time and returns the index of the first match, or -1
+template <class T>
+int vector_find(const T* data, int n, const T& value) {
+    const int lanes = 16 / sizeof(T); // The number of elements compared per iteration
+    const __m128i needle = simd_broadcast<T>(value); // The target value copied into every lane
+    int i = 0;
+    for (; i + lanes <= n; i += lanes) { // Compare one full register per iteration
+        __m128i block = _mm_loadu_si128((const __m128i*)(data + i));
+        unsigned mask = (unsigned)_mm_movemask_epi8(simd_equal<T>(block, needle)); // One bit per matching byte
+        if (mask != 0) { // At least one lane matched, so the lowest set bit belongs to the first match
+            return i + lowest_set_bit(mask) / (int)sizeof(T);
+        }
+    }
+    int rest = scalar_find(data + i, n - i, value); // Finish the tail that does not fill a register
+    return rest == -1 ? -1 : i + rest;
+}
+#else
+// Without vector instructions the integral search is the scalar loop
+template <class T>
+int vector_find(const T* data, int n, const T& value) {
+    return scalar_find(data, n, value);
+}
+#endif
+
+// A function that searches n elements for a value and returns the index of the first match, or -1,
+// picking the vectorized scan for integral types and the scalar loop for everything else
+template <class T>
+int find_element(const T* data, int n, const T& value) {
+    if constexpr (is_simd_searchable<T>::value) {
+        return vector_find(data, n, value);
+    }
+    else {
+        return scalar_find(data, n, value);
+    }
+}
+
+// An overload for strings that rejects most candidates on length and end bytes before comparing the characters
+inline int find_element(const string* data, int n, const string& value) {
+    const size_t length = value.size(); // The length every match must have
+    if (length == 0) { // Only other empty strings can match
+        for (int i = 0; i < n; i++) {
+            if (data[i].empty()) {
+                return i;
+            }
+        }
+        return -1;
+    }
+    const char first = value[0]; // The first byte every match must start with
+    const char last = value[length - 1]; // The last byte every match must end with
+    const char* chars = value.data();
+    for (int i = 0; i < n; i++) { // loop through the elements from 0 to n - 1
+        const string& candidate = data[i];
+        if (candidate.size() == length && candidate[0] == first && candidate[length - 1] == last
+            && memcmp(candidate.data(), chars, length) == 0) { // Compare the full text only when the cheap checks pass
+            return i;
+        }
+    }
+    return -1; // if the element is not found, return -1
+}
+
+// A function that searches n elements of a vector, starting at a given position, and returns the index of the first
+// match counted from that position, or -1. A vector<bool> packs its elements into bits and has no data(), so it is
+// scanned one element at a time.
+template <class T>
+int find_element(const vector<T>& data, int from, int n, const T& value) {
+    if constexpr (is_same<T, bool>::value) {
+        for (int i = 0; i < n; i++) {
+            if (data[from + i] == value) {
+                return i;
+            }
+        }
+        return -1;
+    }
+    else {
+        return find_element(data.data() + from, n, value);
+    }
+}
@@ -0,0 +1,306 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include "ContainerTraits.h"
+using namespace std;
+
+
+// A class template for arrays that keep their elements in ascending order at all times
+template <class T>
+class SortedArray {
+    private:
+        vector<T> data; // The underlying vector to store the elements
+        int size; // The current number of elements in the array
+        int capacity; // The maximum number of elements the array can hold
+
+        // A helper method that returns the first position in [first, first + n) whose element is not less than val, using a branchless binary search
+        int lowerBoundHelper(int first, int n, const T& val) const {
+            if (n <= 0) { // Check if the range is empty
+                return first;
+            }
+            const T* base = data.data() + first; // The start of the remaining search window
+            while (n > 1) { // Halve the window until one candidate is left
+                int half = n / 2;
+                base = (base[half] < val) ? base + half : base; // Compiles to a conditional move instead of a branch
+                n -= half;
+            }
+            return (int)(base - data.data()) + (*base < val); // Step past the last candidate if it is still too small
+        }
+
+        // A helper method that returns the first position in [first, first + n) whose element is greater than val, using a branchless binary search
+        int upperBoundHelper(int first, int n, const T& val) const {
+            if (n <= 0) { // Check if the range is empty
+                return first;
+            }
+            const T* base = data.data() + first; // The start of the remaining search window
+            while (n > 1) { // Halve the window until one candidate is left
+                int half = n / 2;
+                base = (val < base[half]) ? base : base + half; // Compiles to a conditional move instead of a branch
+                n -= half;
+            }
+            return (int)(base - data.data()) + !(val < *base); // Step past the last candidate if it is not greater than val
+        }
+
+        // A helper method that narrows the search window by interpolating on numeric keys, then finishes with a branchless binary search
+        int interpolationLowerBound(const T& val) const {
+            int lo = 0; // Every element before lo is less than val
+            int hi = size - 1; // Every element after hi is not less than val
+            int probes = 0; // The number of interpolation probes made so far
+            while (hi - lo > 32 && probes < 16) { // Interpolate only while the window is large and the keys look uniform enough
+                if (!(data[lo] < val)) { // The whole window is not less than val
+                    return lo;
+                }
+                if (data[hi] < val) { // The whole window is less than val
+                    return hi + 1;
+                }
+                double span = (double)data[hi] - (double)data[lo]; // The key range covered by the window
+                double offset = (double)val - (double)data[lo]; // How far val lies into that range
+                int pos = lo + (int)(offset / span * (hi - lo)); // The position val would occupy if the keys were evenly spaced
+                if (data[pos] < val) { // val lies to the right of the probe
+                    lo = pos + 1;
+                }
+                else { // val lies at or to the left of the probe
+                    hi = pos;
+                }
+                probes++;
+            }
+            return lowerBoundHelper(lo, hi - lo + 1, val); // Finish the small window with the branchless search
+        }
+
+    public:
+        // A default constructor that creates an empty array
+        SortedArray() {
+            size = 0;
+            capacity = 10;
+            data.resize(capacity); // Allocate memory for the vector
+        }
+
+        // A constructor that builds the array from an unsorted range of elements, sorting them once
+        template <class InputIt>
+        SortedArray(InputIt first, InputIt last) {
+            size = 0;
+            capacity = 10;
+            data.resize(capacity); // Allocate memory for the vector
+            assign(first, last);
+        }
+
+        // A const index operator that returns the element at a given position (no mutable access, so the order cannot be broken)
+        const T& operator[](int index) const {
+            if (index >= 0 && index < size) { // Check if the index is valid
+                return data[index]; // Return a const reference to the element at that index
+            }
+            else { // Throw an exception if the index is out of bounds
+                throw out_of_range("Index out of bounds");
+            }
+        }
+
+        // A method that returns the current number of elements in the array
+        int getSize() const {
+            return size;
+        }
+
+        // A method that returns the maximum number of elements the array can hold
+        int getCapacity() const {
+            return capacity;
+        }
+
+        // A method that checks if the array is empty or not
+        bool isEmpty() const {
+            return size == 0;
+        }
+
+        // A method that checks that the elements really are in ascending order
+        bool isSorted() const {
+            return std::is_sorted(data.begin(), data.begin() + size);
+        }
+
+        // A method that grows the capacity to at least n elements in one reallocation, keeping the existing elements
+        void reserve(int n) {
+            if (n > capacity) { // Only grow, never shrink
+                capacity = n;
+                data.resize(capacity); // Resize the vector once for the whole request
+            }
+        }
+
+        // A method that replaces the contents with the elements in [first, last), sorting them once instead of inserting one by one
+        template <class InputIt>
+        void assign(InputIt first, InputIt last) {
+            int count = (int)std::distance(first, last); // The number of new elements
+            reserve(count);
+            size = 0;
+            for (; first != last; ++first) {
+                data[size] = *first; // Copy each element into the next free position
+                size++;
+            }
+            std::sort(data.begin(), data.begin() + size); // Restore the sorted invariant in O(n log n)
+        }
+
+        // A method that inserts a new element after any equal elements, shifting the larger elements to the right, resizing if necessary
+        void insert(T val) {
+            if (size == capacity) { // Check if the array is full
+                capacity *= 2; // Double the capacity
+                data.resize(capacity); // Resize the vector accordingly
+            }
+            int index = upperBound(val); // The position that keeps the array sorted
+            for (int i = size - 1; i >= index; i--) {
+                data[i + 1] = std::move(data[i]); // Shift each larger element one position to the right
+            }
+            data[index] = val; // Assign the new value to its sorted position
+            size++; // Increment the size by one
+        }
+
+        // A method that removes the element at a given position, shifting the existing elements to the left
+        void removeAt(int index) {
+            if (index >= 0 && index < size) { // Check if the index is valid
+                for (int i = index + 1; i < size; i++) {
+                    data[i - 1] = std::move(data[i]); // Shift each element one position to the left from the given index onwards
+                }
+                size--; // Decrement the size by one
+            }
+            else { // Throw an exception if the index is out of bounds
+                throw out_of_range("Index out of bounds");
+            }
+        }
+
+        // A method that removes one element equal to val and returns whether one was found
+        bool remove(T val) {
+            int index = upperBound(val) - 1; // Take the last equal element, so the fewest elements have to shift
+            if (index < 0 || data[index] < val) { // Check if the element exists
+                return false;
+            }
+            removeAt(index);
+            return true;
+        }
+
+        // A method that returns the first position whose element is not less than val
+        int lowerBound(const T& val) const {
+            return lowerBoundHelper(0, size, val);
+        }
+
+        // A method that returns the first position whose element is greater than val
+        int upperBound(const T& val) const {
+            return upperBoundHelper(0, size, val);
+        }
+
+        // A method that returns the half-open range of positions holding elements equal to val
+        pair<int, int> equalRange(const T& val) const {
+            int first = lowerBound(val); // The first equal element, if any
+            return make_pair(first, upperBoundHelper(first, size - first, val)); // Search for the end only to the right of the start
+        }
+
+        // A method that returns the first position not less than val by galloping outwards from a hint, which is fast when consecutive lookups are close together
+        int gallopLowerBound(const T& val, int hint) const {
+            if (size == 0) { // Check if the array is empty
+                return 0;
+            }
+            hint = max(0, min(hint, size - 1)); // Clamp the hint into the array
+            int step = 1; // The current gallop distance, doubled on each step
+            if (data[hint] < val) { // Gallop to the right until an element is not less than val
+                int lo = hint + 1;
+                int hi = lo;
+                while (hi < size && data[hi] < val) {
+                    lo = hi + 1;
+                    hi = hint + step * 2;
+                    step *= 2;
+                }
+                hi = min(hi, size - 1);
+                return lowerBoundHelper(lo, hi - lo + 1, val); // Finish inside the bracket with the branchless search
+            }
+            else { // Gallop to the left until an element is less than val
+                int hi = hint;
+                int lo = hint - 1;
+                while (lo >= 0 && !(data[lo] < val)) {
+                    hi = lo;
+                    lo = hint - step * 2;
+                    step *= 2;
+                }
+                lo = max(lo + 1, 0);
+                return lowerBoundHelper(lo, hi - lo + 1, val); // Finish inside the bracket with the branchless search
+            }
+        }
+
+        // A method to search for an element and return the index of its first occurrence, or -1 if not found
+        int search(T element) const {
+            int index;
+            if constexpr (is_arithmetic<T>::value) { // Numeric keys can be interpolated
+                index = interpolationLowerBound(element);
+            }
+            else { // Other keys use the branchless binary search
+                index = lowerBound(element);
+            }
+            if (index < size && !(element < data[index])) { // The lower bound holds the element only if it is not greater than it
+                return index;
+            }
+            return -1; // if the element is not found, return -1
+        }
+
+        // A method that prints all the elements in the array
+        void print() const {
+            cout << "[";
+            for (int i = 0; i < size; i++) {
+                cout << data[i];
+                if (i != size - 1) {
+                    cout << ", ";
+                }
+            }
+            cout << "]" << endl;
+        }
+
+        vector<int> get_time_taken(vector<T> api, vector<T> data) {
+            vector<int> time_for_ds;
+            for(auto method : api) {
+                auto start = chrono::high_resolution_clock::now();
+
+                if(method == "insert()") {
+                    for(size_t i = 0; i < data.size(); i++){
+                        insert(data.at(i));
+                    }
+                }
+                else if(method == "delete()") {
+                    for(size_t i = (data.size()/2); i < data.size(); i++){
+                        remove(data.at(i));
+                        insert(data.at(i));
+                    }
+                }
+                else if(method == "search()") {
+                    benchmark_sink = search(data.back()); // Keep the result so the scan is not optimized away
+                }
+                else if(method == "size()") {
+                    benchmark_sink = getSize();
+                }
+                else if(method == "sort()") {
+                    benchmark_sink = isSorted(); // Already sorted by construction, so only the check is paid for
+                }
+                auto stop = chrono::high_resolution_clock::now();
+
+                auto duration = chrono::duration_cast<chrono::microseconds>(stop - start);
+
+                time_for_ds.push_back(duration.count());
+            }
+            return time_for_ds;
+        }
+};
+
+// The capabilities and costs the search engine matches workloads against
+template <class T>
+struct container_traits<SortedArray<T>> {
+    static constexpr const char* name = "sorted array";
+    static constexpr unsigned capabilities = Elements | RandomAccess | SortedOrder | Iteration;
+    // Every insert keeps the keys in order, so a search is a binary search
+    static constexpr Complexity insertCost = Complexity::Linear;
+    static constexpr Complexity deleteCost = Complexity::Linear;
+    static constexpr Complexity searchCost = Complexity::Logarithmic;
+
+    static constexpr double bytesPerElement(double elementBytes) {
+        return elementBytes * 1.5;
+    }
+
+    static SortedArray<T> make(size_t) {
+        return SortedArray<T>();
+    }
+};
@@ -1,6 +1,9 @@
+#pragma once
 #include <iostream>
 #include <vector>
 #include <chrono>
+#include "SimdSearch.h"
+#include "ContainerTraits.h"
 
 using namespace std;
 
@@ -11,12 +14,13 @@ class Stack {
         vector<T> data; // The underlying vector to store the elements
         int size; // The current number of elements in the stack
         int capacity; // The maximum number of elements the stack can hold
+        GrowthPolicy growth; // The capacity the stack starts with and how it grows when full
 
     public:
         // A default constructor that creates an empty stack
         Stack() {
             size = 0;
-            capacity = 10;
+            capacity = growth.initialCapacity;
             data.resize(capacity); // Allocate memory for the vector
         }
 
@@ -27,10 +31,19 @@ class Stack {
             data.resize(capacity); // Allocate memory for the vector
         }
 
+        // A constructor that creates an empty stack that starts at and grows by a given policy
+        Stack(GrowthPolicy policy) {
+            size = 0;
+            growth = policy;
+            capacity = max(1, growth.initialCapacity);
+            data.resize(capacity); // Allocate memory for the vector
+        }
+
         // A copy constructor that creates a deep copy of another stack
         Stack(const Stack<T>& other) {
             size = other.size;
             capacity = other.capacity;
+            growth = other.growth;
             data.resize(capacity); // Allocate memory for the vector
             for (int i = 0; i < size; i++) {
                 data[i] = other.data[i]; // Copy each element from the other stack
@@ -47,6 +60,7 @@ class Stack {
             if (this != &other) { // Avoid self-assignment
                 size = other.size;
                 capacity = other.capacity;
+                growth = other.growth;
                 data.resize(capacity); // Allocate memory for the vector
                 for (int i = 0; i < size; i++) {
                     data[i] = other.data[i]; // Copy each element from the other stack
@@ -78,7 +92,7 @@ class Stack {
         // A method that adds a new element at the top of the stack, resizing it if necessary
         void push(T val) {
             if (size == capacity) { // Check if the stack is full
-                capacity *= 2; // Double the capacity
+                capacity = growth.grow(capacity); // Grow the capacity by the growth factor
                 data.resize(capacity); // Resize the vector accordingly
             }
             data[size] = val; // Assign the new value to the top position
@@ -106,14 +120,9 @@ class Stack {
             }
         }
 
-        // A method to search for an element in the stack using linear search
+        // A method to search for an element in the stack using linear search, vectorized for integral types
         int search(T element) {
-            for (int i = 0; i < size; i++) { // loop through the stack elements from bottom to top
-                if (data[i] == element) { // if the current element is equal to the target element, return its index
-                    return i;
-                }
-            }
-            return -1; // if the element is not found, return -1
+            return find_element(data, 0, size, element); // Scan the stack elements from bottom to top, returning -1 if not found
         }
 
         // A method to reverse the stack elements using another stack as a temporary storage
@@ -123,6 +132,8 @@ class Stack {
                 temp.push(pop()); // pop an element from the original stack and push it onto the temporary stack
             }
             data = temp.data; // assign the data vector of the temporary stack to the original stack
+            size = temp.size; // and its count, which the pops above brought down to zero
+            capacity = temp.capacity;
         }
 
         // A method that prints all the elements in the stack from top to bottom 
@@ -155,7 +166,7 @@ class Stack {
                     
                 }
                 else if(method == "search()") {
-                    search(data.back());
+                    benchmark_sink = search(data.back()); // Keep the result so the scan is not optimized away
                 }
                 else if(method == "size()") {
                     int x = getSize();
@@ -172,3 +183,30 @@ class Stack {
             return time_for_ds;
         }
 };
+
+// The capabilities and costs the search engine matches workloads against
+template <class T>
+struct container_traits<Stack<T>> {
+    static constexpr const char* name = "stack";
+    static constexpr unsigned capabilities = Elements | InsertionOrder | LifoOrder | Iteration;
+    // Deleting pops the newest element
+    static constexpr Complexity insertCost = Complexity::Constant;
+    static constexpr Complexity deleteCost = Complexity::Constant;
+    static constexpr Complexity searchCost = Complexity::Linear;
+
+    static constexpr double bytesPerElement(double elementBytes) {
+        return elementBytes * 1.5;
+    }
+
+    static Stack<T> make(size_t) {
+        return Stack<T>();
+    }
+
+    static vector<TuningParameter> tuningSpace(size_t n) {
+        return growth_tuning_space(n);
+    }
+
+    static Stack<T> make(size_t, const vector<double>& setting) {
+        return Stack<T>(growth_policy(setting));
+    }
+};
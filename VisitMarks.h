@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+#include <type_traits>
+using namespace std;
+
+// A class for visited flags that can be cleared in constant time: a vertex counts as visited when its stamp equals
+// the current generation, so starting a new traversal only bumps the generation instead of refilling the whole array
+class VisitMarks {
+    private:
+        vector<unsigned> stamp; // The generation in which each vertex was last visited
+        unsigned generation; // The generation of the traversal in progress
+
+    public:
+        // A default constructor that creates marks for no vertices
+        VisitMarks() {
+            generation = 0;
+        }
+
+        // A method that starts a new traversal over n vertices with every vertex unvisited
+        void begin(int n) {
+            if ((int)stamp.size() != n) { // The graph changed size, so the stamps have to be reallocated
+                stamp.assign(n, 0);
+                generation = 0;
+            }
+            generation++;
+            if (generation == 0) { // The counter wrapped, so old stamps could match again; clear them once
+                stamp.assign(n, 0);
+                generation = 1;
+            }
+        }
+
+        // A method that checks if a vertex has been visited in the current traversal
+        bool isVisited(int v) const {
+            return stamp[v] == generation;
+        }
+
+        // A method that marks a vertex as visited and returns true if it was not visited before
+        bool visit(int v) {
+            if (stamp[v] == generation) {
+                return false;
+            }
+            stamp[v] = generation;
+            return true;
+        }
+};
+
+// A helper function that calls a traversal visitor on a vertex and returns whether the traversal should go on.
+// A visitor returning bool stops the traversal by returning false; a visitor returning void always goes on.
+template <class Visitor>
+bool call_visitor(Visitor& visit, int v) {
+    if constexpr (is_same<decltype(visit(v)), bool>::value) {
+        return visit(v);
+    }
+    else {
+        visit(v);
+        return true;
+    }
+}